@@ -0,0 +1,255 @@
+/*
+ * Micro-benchmark of the set and hash table kernels used by the enumeration.
+ *
+ * Sweeps set sizes, size ratios, overlap fractions and hash table load factors
+ * and reports ns per element and GB/s for SimpleHashSet::intersect,
+ * intersection_size and exclude, SimpleHashTable::insert, hopscotchInsert,
+ * contains and vector_lookup, and UnrolledList::push_back and remove (which is
+ * a find_element followed by a pop_back).
+ * The instruction set is fixed at compile time by utils.h, so the kernels are
+ * built twice: mce_bench with AVX-512 and mce_bench_scalar without it.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <sstream>
+
+#include <tbb/tick_count.h>
+
+#include "SetImplementation.h"
+#include "utils.h"
+
+using namespace std;
+
+MemUsageLogger *memLogger = NULL;
+bool CollectMemUsage = false;
+
+#ifdef USE_AVX512
+const string ISA = "avx512";
+#else
+const string ISA = "scalar";
+#endif
+
+const long WORK_PER_MEASUREMENT = 1 << 22; // elements processed per timed measurement
+int reps = 5;
+string kernel_filter = "";
+volatile long sink = 0;
+
+struct Case {
+    int n;          // size of the probing side
+    double ratio;   // size of the hashed side relative to n
+    double overlap; // fraction of the probing side found in the hashed side
+    double load;    // hash table load factor, 0 if not applicable
+};
+
+// Runs f iters times per repetition and returns the fastest time per call in seconds
+template <typename TF>
+double measure(long iters, TF&& f) {
+    double best = -1;
+    for(int r = 0; r < reps; r++) {
+        auto tick0 = tbb::tick_count::now();
+        for(long i = 0; i < iters; i++) f();
+        double t = (tbb::tick_count::now() - tick0).seconds() / iters;
+        if(best < 0 || t < best) best = t;
+    }
+    return best;
+}
+
+void report(string kernel, const Case& c, long elems, long bytes, double t) {
+    cout << kernel << ", " << ISA << ", " << c.n << ", " << c.ratio << ", " << c.overlap << ", " << c.load << ", "
+         << t * 1e9 / max(1L, elems) << ", " << bytes / t / 1e9 << endl;
+}
+
+bool selected(string kernel) { return kernel_filter.empty() || kernel.find(kernel_filter) != string::npos; }
+
+// Distinct non-negative keys, so that they never collide with EMPTY_KEY and INVAL_KEY
+vector<KeyType> distinct_keys(int count, mt19937& rng) {
+    vector<KeyType> keys(count);
+    for(int i = 0; i < count; i++) keys[i] = i * 7 + 3;
+    shuffle(keys.begin(), keys.end(), rng);
+    return keys;
+}
+
+// Capacity that SimpleHashTable::reserve picks for cap
+size_t table_capacity(size_t cap) { return (size_t) 1 << (32 - __builtin_clz(2*cap-1)); }
+
+// Reservation that gives approximately the requested load factor for n elements
+size_t reservation_for_load(int n, double load) { return max((size_t) 1, (size_t)(n / (2 * load))); }
+
+/****************** Set kernels ***********************/
+void bench_sets(const Case& c, mt19937& rng) {
+    int m = max(1, (int)(c.n * c.ratio));
+    int common = min(m, (int)(c.n * c.overlap));
+    vector<KeyType> keys = distinct_keys(c.n + m, rng);
+
+    // a: the first n keys; b: common keys of a plus keys not in a
+    SET_IMPL *a = SET_IMPL::create_set();
+    SET_IMPL *b = SET_IMPL::create_set();
+    for(int i = 0; i < c.n; i++) a->add_elem(keys[i]);
+    for(int i = 0; i < common; i++) b->add_elem(keys[i]);
+    for(int i = c.n; i < c.n + m - common; i++) b->add_elem(keys[i]);
+    b->hashSet();
+
+    long iters = max(1L, WORK_PER_MEASUREMENT / c.n);
+    long bytes = (long) c.n * sizeof(KeyType);
+    if(selected("intersect")) {
+        double t = measure(iters, [&]() { SET_IMPL* r = a->intersect(b); sink += r->size(); delete r; });
+        report("intersect", c, c.n, bytes, t);
+    }
+    if(selected("intersection_size")) {
+        double t = measure(iters, [&]() { sink += a->intersection_size(b); });
+        report("intersection_size", c, c.n, bytes, t);
+    }
+    if(selected("exclude")) {
+        double t = measure(iters, [&]() { SET_IMPL* r = a->exclude(b); sink += r->size(); delete r; });
+        report("exclude", c, c.n, bytes, t);
+    }
+    delete a; delete b;
+}
+
+/****************** Hash table kernels ***********************/
+void bench_table(const Case& c, mt19937& rng) {
+    vector<KeyType> keys = distinct_keys(2 * c.n, rng);
+    size_t cap = reservation_for_load(c.n, c.load);
+    Case actual = c;
+    actual.load = (double) c.n / table_capacity(cap);
+    long iters = max(1L, WORK_PER_MEASUREMENT / c.n);
+    long bytes = (long) c.n * sizeof(KeyType);
+
+    if(selected("table_insert")) {
+        double t = measure(iters, [&]() {
+            SimpleHashTable table; table.reserve(cap);
+            for(int i = 0; i < c.n; i++) table.insert(keys[i]);
+            sink += table.size();
+        });
+        report("table_insert", actual, c.n, bytes, t);
+    }
+#ifdef USE_HOPSCOTCH
+    if(selected("hopscotch_insert")) {
+        double t = measure(iters, [&]() {
+            SimpleHashTable table; table.reserve(cap);
+            for(int i = 0; i < c.n; i++) table.hopscotchInsert(keys[i]);
+            sink += table.size();
+        });
+        report("hopscotch_insert", actual, c.n, bytes, t);
+    }
+#endif
+
+    // Lookups of n keys of which the overlap fraction is in the table
+    SimpleHashTable table; table.reserve(cap);
+    for(int i = 0; i < c.n; i++) {
+#ifdef USE_HOPSCOTCH
+        table.hopscotchInsert(keys[i]);
+#else
+        table.insert(keys[i]);
+#endif
+    }
+    int hits = (int)(c.n * c.overlap);
+    vector<KeyType> queries(keys.begin(), keys.begin() + hits);
+    queries.insert(queries.end(), keys.begin() + c.n, keys.begin() + 2 * c.n - hits);
+    shuffle(queries.begin(), queries.end(), rng);
+    queries.resize((queries.size() + VECTOR_SIZE - 1) / VECTOR_SIZE * VECTOR_SIZE, queries.empty() ? 0 : queries[0]);
+
+    if(selected("table_contains")) {
+        double t = measure(iters, [&]() {
+            long found = 0;
+            for(int i = 0; i < c.n; i++) found += table.contains(queries[i]);
+            sink += found;
+        });
+        report("table_contains", actual, c.n, bytes, t);
+    }
+#ifdef USE_AVX512
+    if(selected("vector_lookup")) {
+        double t = measure(iters, [&]() {
+            long found = 0;
+            for(size_t i = 0; i < queries.size(); i += VECTOR_SIZE)
+                found += _mm_popcnt_u32(table.vector_lookup(_mm512_loadu_si512(queries.data() + i)));
+            sink += found;
+        });
+        report("vector_lookup", actual, c.n, bytes, t);
+    }
+#endif
+}
+
+/****************** Unrolled list kernels ***********************/
+void bench_list(const Case& c, mt19937& rng) {
+    vector<KeyType> keys = distinct_keys(c.n, rng);
+    long iters = max(1L, WORK_PER_MEASUREMENT / c.n);
+    long bytes = (long) c.n * sizeof(KeyType);
+
+    if(selected("list_push_back")) {
+        double t = measure(iters, [&]() {
+            UnrolledList list;
+            for(int i = 0; i < c.n; i++) list.push_back(keys[i]);
+            sink += list.size();
+        });
+        report("list_push_back", c, c.n, bytes, t);
+    }
+    if(selected("list_remove")) {
+        // Removes a random element and appends it again, the search scans half of the list on average
+        UnrolledList list;
+        for(int i = 0; i < c.n; i++) list.push_back(keys[i]);
+        uniform_int_distribution<int> dist(0, c.n - 1);
+        vector<KeyType> victims(256);
+        for(auto& v : victims) v = keys[dist(rng)];
+        long ops = max(1L, WORK_PER_MEASUREMENT / c.n / 8);
+        size_t k = 0;
+        double t = measure(ops, [&]() {
+            KeyType v = victims[k++ % victims.size()];
+            list.remove(v); list.push_back(v);
+        });
+        report("list_remove", c, c.n / 2, bytes / 2, t);
+    }
+}
+
+vector<double> parse_list(string s) {
+    vector<double> values;
+    stringstream ss(s);
+    string item;
+    while(getline(ss, item, ',')) values.push_back(stod(item));
+    return values;
+}
+
+inline void printBenchHelp() {
+    std::cout << " Set and hash table kernel benchmark " << std::endl;
+    std::cout << "    -s                Comma separated set sizes, default 16,64,256,1024,4096,16384" << std::endl;
+    std::cout << "    --ratio           Comma separated size ratios of the hashed to the probing set, default 1,4,16" << std::endl;
+    std::cout << "    --overlap         Comma separated fractions of the probing set found in the hashed set, default 0,0.5,1" << std::endl;
+    std::cout << "    --load            Comma separated hash table load factors, default 0.25,0.5,0.75;" << std::endl;
+    std::cout << "                      the actual load is reported, since capacities are powers of two" << std::endl;
+    std::cout << "    -k                Runs only the kernels whose name contains the argument" << std::endl;
+    std::cout << "    -r                Number of repetitions, the fastest one is reported, default 5" << std::endl;
+    std::cout << "    -h, --help        Shows this message" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if(cmdOptionExists(argv, argv+argc, "-h") || cmdOptionExists(argv, argv+argc, "--help")) {
+        printBenchHelp(); return 0;
+    }
+    vector<double> sizes = {16, 64, 256, 1024, 4096, 16384};
+    vector<double> ratios = {1, 4, 16};
+    vector<double> overlaps = {0, 0.5, 1};
+    vector<double> loads = {0.25, 0.5, 0.75};
+    if(cmdOptionExists(argv, argv+argc, "-s")) sizes = parse_list(string(getCmdOption(argv, argv + argc, "-s")));
+    if(cmdOptionExists(argv, argv+argc, "--ratio")) ratios = parse_list(string(getCmdOption(argv, argv + argc, "--ratio")));
+    if(cmdOptionExists(argv, argv+argc, "--overlap")) overlaps = parse_list(string(getCmdOption(argv, argv + argc, "--overlap")));
+    if(cmdOptionExists(argv, argv+argc, "--load")) loads = parse_list(string(getCmdOption(argv, argv + argc, "--load")));
+    if(cmdOptionExists(argv, argv+argc, "-k")) kernel_filter = string(getCmdOption(argv, argv + argc, "-k"));
+    if(cmdOptionExists(argv, argv+argc, "-r")) reps = max(1, stoi(string(getCmdOption(argv, argv + argc, "-r"))));
+
+    mt19937 rng(42);
+    cout << "# kernel, isa, n, ratio, overlap, load, ns_per_elem, GB_per_s" << endl;
+    for(double size : sizes) {
+        int n = max(1, (int) size);
+        for(double ratio : ratios)
+            for(double overlap : overlaps)
+                bench_sets({n, ratio, overlap, 0}, rng);
+        for(double load : loads)
+            for(double overlap : overlaps)
+                bench_table({n, 1, overlap, load}, rng);
+        bench_list({n, 1, 0, 0}, rng);
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Contention micro-benchmark for the task bookkeeping used by the BK tasks.
+ *
+ * Spawns a binary tree of tiny tasks that do nothing but the bookkeeping every
+ * MainBKTask does: count themselves and take/release a reference on a shared
+ * graph guard (a fresh guard is created every few levels, as with subgraphs).
+ * The legacy variant uses a global atomic task id and a spin_mutex protected
+ * reference count on heap allocated guards; the current variant uses BKTask and
+ * GraphGuard as they are used by the enumeration.
+ */
+#include <iostream>
+#include <string>
+
+#include <tbb/task.h>
+#include <tbb/task_scheduler_init.h>
+#include <tbb/tick_count.h>
+#include <tbb/spin_mutex.h>
+#include <tbb/atomic.h>
+
+#include "BKTask.h"
+#include "utils.h"
+
+using namespace std;
+
+MemUsageLogger *memLogger = NULL;
+bool CollectMemUsage = false;
+
+int guard_every = 4; // create a new guard every guard_every levels
+
+/****************** Legacy bookkeeping ***********************/
+struct LockedGraphGuard {
+    LockedGraphGuard(Graph *g) : graph(g), ref_count(1) {}
+    void inc_graph_ref_count() {
+        MutexType::scoped_lock lock(RefCountMutex);
+        ref_count++;
+    }
+    void dec_graph_ref_count() {
+        bool last = false;
+        {
+            MutexType::scoped_lock lock(RefCountMutex);
+            last = (--ref_count <= 0);
+        }
+        if(last) { delete graph; delete this; }
+    }
+    Graph* graph;
+    int ref_count;
+    typedef tbb::spin_mutex MutexType;
+    MutexType RefCountMutex;
+};
+
+tbb::atomic<unsigned long> legacyTaskIdCnt;
+
+class LegacyTinyTask : public tbb::task {
+public:
+    LegacyTinyTask(LockedGraphGuard *g, int _depth) : taskId(legacyTaskIdCnt++), guard(g),
+        depth(_depth), isContinuation(false) {}
+    tbb::task* execute() override {
+        if(isContinuation || depth == 0) { guard->dec_graph_ref_count(); return NULL; }
+        LockedGraphGuard* child_guard = guard;
+        if(depth % guard_every == 0) child_guard = new LockedGraphGuard(new Graph(0));
+        else child_guard->inc_graph_ref_count();
+        child_guard->inc_graph_ref_count();
+        set_ref_count(3);
+        spawn(*new(allocate_child()) LegacyTinyTask(child_guard, depth-1));
+        spawn(*new(allocate_child()) LegacyTinyTask(child_guard, depth-1));
+        recycle_as_safe_continuation();
+        isContinuation = true;
+        return NULL;
+    }
+private:
+    unsigned long taskId;
+    LockedGraphGuard *guard;
+    int depth;
+    bool isContinuation;
+};
+
+/****************** Current bookkeeping ***********************/
+class TinyBKTask : public BKTask {
+public:
+    TinyBKTask(GraphGuard *g, int _depth) : BKTask(g), depth(_depth), isContinuation(false) {}
+protected:
+    tbb::task* SpawnTask() override {
+        if(isContinuation || depth == 0) { graphg->dec_graph_ref_count(graphg); return NULL; }
+        GraphGuard* child_guard = graphg;
+        if(depth % guard_every == 0) child_guard = new GraphGuard(new Graph(0));
+        else child_guard->inc_graph_ref_count();
+        child_guard->inc_graph_ref_count();
+        set_ref_count(3);
+        spawn(*new(allocate_child()) TinyBKTask(child_guard, depth-1));
+        spawn(*new(allocate_child()) TinyBKTask(child_guard, depth-1));
+        recycle_as_safe_continuation();
+        isContinuation = true;
+        return NULL;
+    }
+private:
+    int depth;
+    bool isContinuation;
+};
+
+inline void printBenchHelp() {
+    std::cout << " Task bookkeeping contention benchmark " << std::endl;
+    std::cout << "    -n                Number of threads, default 256" << std::endl;
+    std::cout << "    -d                Depth of the binary task tree, default 22" << std::endl;
+    std::cout << "    -g                Create a new graph guard every g levels, default 4" << std::endl;
+    std::cout << "    -r                Number of repetitions, default 3" << std::endl;
+    std::cout << "    -h, --help        Shows this message" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if(cmdOptionExists(argv, argv+argc, "-h") || cmdOptionExists(argv, argv+argc, "--help")) {
+        printBenchHelp(); return 0;
+    }
+    int nthr = 256, depth = 22, reps = 3;
+    if(cmdOptionExists(argv, argv+argc, "-n")) nthr = stoi(string(getCmdOption(argv, argv + argc, "-n")));
+    if(cmdOptionExists(argv, argv+argc, "-d")) depth = stoi(string(getCmdOption(argv, argv + argc, "-d")));
+    if(cmdOptionExists(argv, argv+argc, "-g")) guard_every = max(1, stoi(string(getCmdOption(argv, argv + argc, "-g"))));
+    if(cmdOptionExists(argv, argv+argc, "-r")) reps = stoi(string(getCmdOption(argv, argv + argc, "-r")));
+
+    tbb::task_scheduler_init init(nthr);
+    cout << "# threads = " << nthr << ", depth = " << depth << ", guard every " << guard_every << " levels" << endl;
+    cout << "# variant, repetition, tasks, time_s, Mtasks_per_s" << endl;
+    for(int rep = 0; rep < reps; rep++) {
+        legacyTaskIdCnt = 0;
+        auto tick0 = tbb::tick_count::now();
+        LockedGraphGuard *lg = new LockedGraphGuard(new Graph(0));
+        tbb::task::spawn_root_and_wait(*new(tbb::task::allocate_root()) LegacyTinyTask(lg, depth));
+        double legacy_time = (tbb::tick_count::now() - tick0).seconds();
+        cout << "legacy, " << rep << ", " << legacyTaskIdCnt << ", " << legacy_time << ", "
+             << legacyTaskIdCnt / legacy_time / 1e6 << endl;
+
+        BKTask::reset_task_count();
+        tick0 = tbb::tick_count::now();
+        GraphGuard *gg = new GraphGuard(new Graph(0));
+        tbb::task::spawn_root_and_wait(*new(tbb::task::allocate_root()) TinyBKTask(gg, depth));
+        double current_time = (tbb::tick_count::now() - tick0).seconds();
+        unsigned long tasks = BKTask::get_task_count();
+        cout << "current, " << rep << ", " << tasks << ", " << current_time << ", "
+             << tasks / current_time / 1e6 << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#ifndef _ALGO_STATS_H_
+#define _ALGO_STATS_H_
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <tbb/combinable.h>
+
+// Hot path counters of the enumeration. They are compiled in only with COLLECT_ALGO_STATS
+// (cmake -DALGO_STATS=ON); otherwise the ALGO_STAT_* macros expand to nothing.
+
+enum AlgoCounter { STAT_NODES = 0, STAT_LEAVES, STAT_DEAD_ENDS, STAT_INTERSECTIONS, STAT_LOOKUPS,
+        STAT_SCALAR_FALLBACKS, STAT_HS_RECONSTRUCTS, STAT_SUBGRAPHS, STAT_CHUNK_ALLOCS, STAT_CHUNK_BLOCKS, STAT_PRUNED,
+        NUM_OF_ALGO_COUNTERS };
+const std::string ALGO_COUNTER_NAMES[] = {"Search tree nodes", "Leaves (maximal cliques)", "Dead ends (X not empty)",
+        "Intersections", "Vector lookup lanes", "Scalar lookup fallbacks", "Hopscotch reconstructs",
+        "Subgraphs built", "Chunk allocations", "Chunk blocks", "Pruned subtrees"};
+
+enum AlgoHistogram { HIST_P_SIZE = 0, HIST_X_SIZE, HIST_CAND_SIZE, HIST_INTERSECT_IN, HIST_INTERSECT_HASHED,
+        HIST_INTERSECT_OUT, HIST_PROBE_LENGTH, NUM_OF_ALGO_HISTOGRAMS };
+const std::string ALGO_HISTOGRAM_NAMES[] = {"|P|", "|X|", "|cand|", "Intersection input (list)",
+        "Intersection input (hashed)", "Intersection output", "Probe length"};
+
+// Values are bucketed by log2: bucket 0 holds 0, bucket k holds [2^(k-1), 2^k)
+const int ALGO_HIST_BUCKETS = 33;
+
+struct AlgoStats {
+    AlgoStats() {
+        for(int i = 0; i < NUM_OF_ALGO_COUNTERS; i++) counters[i] = 0;
+        for(int h = 0; h < NUM_OF_ALGO_HISTOGRAMS; h++) {
+            sums[h] = 0;
+            for(int b = 0; b < ALGO_HIST_BUCKETS; b++) hist[h][b] = 0;
+        }
+    }
+    void record(int h, long value) {
+        hist[h][value <= 0 ? 0 : 64 - __builtin_clzl(value)]++;
+        sums[h] += value;
+    }
+    long counters[NUM_OF_ALGO_COUNTERS];
+    long hist[NUM_OF_ALGO_HISTOGRAMS][ALGO_HIST_BUCKETS];
+    long sums[NUM_OF_ALGO_HISTOGRAMS];
+};
+
+inline tbb::combinable<AlgoStats>& pt_algo_stats() {
+    static tbb::combinable<AlgoStats> stats;
+    return stats;
+}
+
+#ifdef COLLECT_ALGO_STATS
+#define ALGO_STAT_INC(c) (pt_algo_stats().local().counters[c]++)
+#define ALGO_STAT_ADD(c, v) (pt_algo_stats().local().counters[c] += (v))
+#define ALGO_STAT_HIST(h, v) (pt_algo_stats().local().record(h, v))
+#else
+#define ALGO_STAT_INC(c) ((void)0)
+#define ALGO_STAT_ADD(c, v) ((void)0)
+#define ALGO_STAT_HIST(h, v) ((void)0)
+#endif
+
+inline AlgoStats combinedAlgoStats() {
+    AlgoStats total;
+    pt_algo_stats().combine_each([&](const AlgoStats& s) {
+        for(int i = 0; i < NUM_OF_ALGO_COUNTERS; i++) total.counters[i] += s.counters[i];
+        for(int h = 0; h < NUM_OF_ALGO_HISTOGRAMS; h++) {
+            total.sums[h] += s.sums[h];
+            for(int b = 0; b < ALGO_HIST_BUCKETS; b++) total.hist[h][b] += s.hist[h][b];
+        }
+    });
+    return total;
+}
+
+inline void printAlgoStats() {
+    AlgoStats total = combinedAlgoStats();
+
+    std::cout << "Algorithm counters:" << std::endl;
+    for(int i = 0; i < NUM_OF_ALGO_COUNTERS; i++)
+        std::cout << "   " << ALGO_COUNTER_NAMES[i] << ": " << total.counters[i] << std::endl;
+    long nodes = total.counters[STAT_NODES], lanes = total.counters[STAT_LOOKUPS];
+    if(nodes) std::cout << "   Dead end ratio: " << (double) total.counters[STAT_DEAD_ENDS] / nodes << std::endl;
+    if(lanes) std::cout << "   Scalar fallback ratio: " << (double) total.counters[STAT_SCALAR_FALLBACKS] / lanes << std::endl;
+
+    for(int h = 0; h < NUM_OF_ALGO_HISTOGRAMS; h++) {
+        long cnt = 0;
+        int last = 0;
+        for(int b = 0; b < ALGO_HIST_BUCKETS; b++) if(total.hist[h][b]) { cnt += total.hist[h][b]; last = b; }
+        std::cout << ALGO_HISTOGRAM_NAMES[h] << " distribution (" << cnt << " samples";
+        if(cnt) std::cout << ", mean " << std::setprecision(3) << (double) total.sums[h] / cnt << std::setprecision(6);
+        std::cout << "):" << std::endl;
+        if(!cnt) continue;
+        for(int b = 0; b <= last; b++) {
+            long lo = b == 0 ? 0 : 1L << (b - 1), hi = b == 0 ? 0 : (1L << b) - 1;
+            std::cout << "   [" << lo << ", " << hi << "]: " << total.hist[h][b] << std::endl;
+        }
+    }
+}
+
+#endif//_ALGO_STATS_H_
@@ -0,0 +1,58 @@
+#ifndef _AUTOTUNE_H_
+#define _AUTOTUNE_H_
+
+#include <string>
+#include <vector>
+
+#include "Graph.h"
+
+using namespace std;
+
+// Settings picked by the autotuner, see -s, --thresh, -o, --mem-thresh and -b
+struct TunedSettings {
+    int subgraphBased;
+    int PX_threshold;
+    bool setsMempool;
+    int mem_threshold;
+    unsigned int memBlockSize;
+};
+
+struct GraphStatistics {
+    long nodes, edges;
+    int maxdeg, degeneracy;
+    double mean_deg, deg_p50, deg_p90, deg_p99;
+    double root_p_mean, root_x_mean;
+    int root_p_max, root_x_max;
+};
+
+class Autotuner {
+public:
+    Autotuner(Graph* g, int _nthr, int _sample_size = 64) : stats(), best(), graph(g), nthr(_nthr), sample_size(_sample_size),
+        sampledCost(0), totalCost(0), best_time(0) {}
+
+    void collectStatistics();
+    void tune();
+    bool loadCache(string path);
+    void saveCache(string path);
+    void apply();
+    void printData();
+
+    // Reads or sets the global engine settings
+    static TunedSettings current();
+    static void set(const TunedSettings& s);
+
+    GraphStatistics stats;
+    TunedSettings best;
+private:
+    double trial(const TunedSettings& s, double time_limit);
+    void tryCandidates(const vector<TunedSettings>& candidates);
+
+    Graph* graph;
+    int nthr;
+    int sample_size;
+    vector<int> sampledRoots; // positions in the vertex ordering
+    long sampledCost, totalCost; // RootIterBKTask::root_set_cost of the sample and of all the roots
+    double best_time;
+};
+
+#endif//_AUTOTUNE_H_
@@ -8,12 +8,23 @@
 #include <tbb/spin_mutex.h>
 #include <tbb/mutex.h>
 #include <tbb/atomic.h>
+#include <tbb/combinable.h>
+#include <tbb/tick_count.h>
 
 #include "Graph.h"
 #include "SetImplementation.h"
 #include "utils.h"
 #include "MemChunk.h"
 #include "UnrolledList.h"
+#include "RootLog.h"
+#include "TaskTrace.h"
+#include "PerfCounters.h"
+#include "MaxClique.h"
+#include "TopKCliques.h"
+#include "VertexStats.h"
+#include "VertexQuery.h"
+#include "Checkpoint.h"
+#include "Progress.h"
 
 using namespace std;
 
@@ -22,6 +33,22 @@ typedef UnrolledList Clique;
 
 extern unsigned int memBlockSize;
 extern bool setsMempool;
+extern bool degeneracyOrd;
+extern bool degreeOrd;
+extern int root_cost_mode;
+extern int eager_roots;
+extern RootLog *rootLog;
+extern RootSizeStats *rootStats;
+extern TaskTracer *taskTracer;
+extern PerfCounters *perfCounters;
+extern MaxClique *maxClique;
+extern TopKCliques *topK;
+extern VertexStats *vertexStats;
+extern VertexQueries *vertexQueries;
+extern Checkpoint *checkpoint;
+extern Progress *progress;
+extern bool idleSplit;
+extern bool edgeRoots;
 
 typedef tbb::spin_mutex CoutMutexType;
 
@@ -31,40 +58,157 @@ struct GraphGuard {
         if(chunk) chunk->increment_allocations();
     }
 
-    void inc_graph_ref_count();
+    void inc_graph_ref_count() { ref_count.fetch_and_increment(); }
     void dec_graph_ref_count(GraphGuard*& this_guard);
+
+    // Guards are recycled through a per-thread free list instead of the global heap
+    void* operator new(size_t size);
+    void operator delete(void* ptr);
+
     Graph* graph;
     MemChunk* my_chunk;
-    int ref_count;
-    typedef tbb::spin_mutex RefCountMutexType;
-    RefCountMutexType RefCountMutex;
+    tbb::atomic<int> ref_count;
 
     ~GraphGuard(){}
 };
 
+/****************** Graph Guard Pool ***********************/
+// Per-thread free list of guard-sized blocks. A guard released by another thread
+// than the one that allocated it simply migrates to the releasing thread's list.
+class GraphGuardPool {
+public:
+    GraphGuardPool() : head(NULL), size(0) {}
+    ~GraphGuardPool() {
+        while(head) { FreeBlock* next = head->next; ::operator delete(head); head = next; }
+    }
+    void* get() {
+        if(!head) return ::operator new(sizeof(GraphGuard));
+        FreeBlock* block = head; head = head->next; size--;
+        return block;
+    }
+    void put(void* ptr) {
+        if(size >= MAX_POOL_SIZE) { ::operator delete(ptr); return; }
+        FreeBlock* block = (FreeBlock*) ptr;
+        block->next = head; head = block; size++;
+    }
+    static GraphGuardPool& local() { static thread_local GraphGuardPool pool; return pool; }
+private:
+    struct FreeBlock { FreeBlock* next; };
+    static const int MAX_POOL_SIZE = 4096;
+    FreeBlock* head;
+    int size;
+};
+
+inline void* GraphGuard::operator new(size_t size) { return GraphGuardPool::local().get(); }
+inline void GraphGuard::operator delete(void* ptr) { if(ptr) GraphGuardPool::local().put(ptr); }
+
+inline void GraphGuard::dec_graph_ref_count(GraphGuard*& this_guard) {
+    // Only the thread dropping the last reference tears the guard down
+    if(ref_count.fetch_and_decrement() > 1) return;
+    if(!graph->my_chunk) delete graph;
+    else graph->~Graph();
+    graph = NULL;
+    if(!my_chunk) delete this;
+    else my_chunk->decrement_allocations();
+    this_guard = NULL;
+}
+
 /****************** BK Task ***********************/
 class BKTask : public tbb::task {
 public:
-    BKTask(GraphGuard *g): taskId(taskIdCnt++), graphg(g) {}
+    BKTask(GraphGuard *g): graphg(g) { task_counter().local()++; }
     virtual ~BKTask(){}
     virtual tbb::task* execute() override { auto *t = SpawnTask(); return t; }
-    void print_tasks_timestamp();
+    static unsigned long get_task_count();
+    static void reset_task_count() { task_counter().clear(); }
 protected:
-    static tbb::atomic<unsigned long> taskIdCnt;
-    int taskId;
+    // Tasks are counted per thread and summed only when the count is requested
+    static tbb::combinable<unsigned long>& task_counter() {
+        static tbb::combinable<unsigned long> cnt([]() { return 0UL; });
+        return cnt;
+    }
     virtual tbb::task* SpawnTask() = 0;
     GraphGuard *graphg;
 };
 
+inline unsigned long BKTask::get_task_count() {
+    unsigned long total = 0;
+    task_counter().combine_each([&](unsigned long cnt) { total += cnt; });
+    return total;
+}
+
+/****************** Work demand ***********************/
+// Cheap hint whether workers are running out of stealable work. It is written only when a root
+// task starts and when sequential work is split off, so polling it from the hot path is cheap.
+// Work is only in demand once every root has started and every split off task has been taken:
+// a split task that is still waiting means no worker has asked for it yet.
+struct WorkDemand {
+    static tbb::atomic<long> pending_roots;  // spawned root tasks that have not started yet
+    static tbb::atomic<long> pending_splits; // split off tasks that have not started yet
+    static bool idle_workers() { return pending_roots == 0 && pending_splits == 0; }
+};
+
+// A sequential subtree is only split with at least this many iterations left, fewer are not worth
+// copying P and X for
+const int MIN_SPLIT_ITERATIONS = 4;
+
+/****************** Search bound ***********************/
+// Smallest size of the maximal cliques that are still of interest, 0 enumerates all of them.
+// A subtree with |R|+|P| below it cannot produce such a clique and is cut.
+struct SearchBound {
+    static tbb::atomic<int> required;
+    static bool prunes(int r_size, int p_size) { return r_size + p_size < required; }
+    // The bound only grows, concurrent raises keep the largest value
+    static void raise(int size) {
+        int cur = required;
+        while(cur < size) {
+            int old = required.compare_and_swap(size, cur);
+            if(old == cur) break;
+            cur = old;
+        }
+    }
+};
+
+/****************** Time budget ***********************/
+// Set once the --time-limit deadline has passed: roots that have not started yet are dropped and
+// the running ones stop branching, so the enumeration drains without new work.
+struct TimeBudget {
+    static tbb::atomic<bool> expired;
+};
+
+/****************** Root sets ***********************/
+// Decides whether a neighbour of the root vertex goes to P (true) or X (false) of the root task
+inline bool is_root_candidate(Graph* graph, int root, int vertex) {
+    if (degeneracyOrd) return graph->getNodePosition(vertex) > graph->getNodePosition(root);
+    int this_vertex_size = graph->getAdjacentNodes(vertex)->size();
+    int other_vertex_size = graph->getAdjacentNodes(root)->size();
+    return (degreeOrd && (this_vertex_size > other_vertex_size) || !degreeOrd && (this_vertex_size < other_vertex_size))
+           || (this_vertex_size == other_vertex_size && vertex > root);
+}
+
+// P of the root task: the candidates above, or every neighbour of a vertex query
+inline bool in_root_P(Graph* graph, int root, int vertex) {
+    return vertexQueries || is_root_candidate(graph, root, vertex);
+}
+
 /****************** Root Iter Task ***********************/
 
 class RootIterBKTask : public BKTask {
 public:
-    RootIterBKTask(GraphGuard *g): BKTask(g), isContinuation(false) {}
+    RootIterBKTask(GraphGuard *g, const vector<int>* _roots = NULL): BKTask(g), isContinuation(false), selectedRoots(_roots),
+        requiredSize(0) {}
     virtual tbb::task* execute() override;
+    static long estimate_root_cost(Graph* graph, int vertex);
+    // |P| * (|X| + 1) of the root sets, independent of the iteration order of the sets
+    static long root_set_cost(Graph* graph, int vertex);
+    int count_vertex_roots(Graph* graph, int vertex);
+    bool prunes_vertex_roots(Graph* graph, int vertex);
 protected:
     virtual tbb::task* SpawnTask() override;
+    void spawn_vertex_roots(Graph* graph, int vertex, long cost, bool eager);
     bool isContinuation;
+    const vector<int>* selectedRoots; // positions of the root vertices, all vertices if NULL
+    int requiredSize; // SearchBound when the roots are spawned, counting and spawning must agree on it
 };
 
 /****************** Main BK Task ***********************/
@@ -74,10 +218,12 @@ public:
     MainBKTask(Clique *_r, SET_IMPL *_p, SET_IMPL *_x, GraphGuard *gg, bool _ir = false,
                MainBKTask* _par = NULL, bool _ret_clq = false);
 
-    MainBKTask(int vertex, GraphGuard*& g, bool _ir = false);
+    MainBKTask(int vertex, GraphGuard*& g, bool _ir = false, long _cost = 0, bool _eager = false, int _second = -1);
 
     virtual ~MainBKTask() {
         if(R_task) delete R_task;
+        if(cliqueSizes) delete cliqueSizes;
+        if(rootSizes) delete[] rootSizes;
         if(CollectMemUsage) {
                 if(parent) memLogger->delTmpMem(sizeof(MainBKTask), MemType::TASK);
                 else memLogger->delTmpMem(sizeof(MainBKTask), MemType::ROOT_TASK);
@@ -89,6 +235,8 @@ protected:
     tbb::task* Continuation();
 
     tbb::task* SequentialRun(Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGuard* Hpx);
+    void SplitRemaining(Clique& R, SET_IMPL*& P, SET_IMPL*& X, SET_IMPL*& cand, GraphGuard* gg);
+    void resume(SET_IMPL* cand);
     bool StartTask(Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGuard*& gg, /*out*/ SET_IMPL*& cand);
     tbb::task* LoopIteration(int vertex, Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGuard*& gg, bool seq = false);
 
@@ -99,6 +247,7 @@ protected:
     int taskLevel;
 
     int new_vertex;
+    int second_vertex; // second vertex of an edge root, -1 otherwise
 
     // Parameters
     Clique *R_task;
@@ -108,8 +257,25 @@ protected:
 
     bool isContinuation;
     bool newTask;
+    bool isSplit;
+    bool hasSplit; // this task already split off its remaining work once, it does not split again
 
     long spawnCnt;
+
+    // Root task bookkeeping
+    long rootCost;
+    bool eagerSplit;
+    int rootPsize, rootXsize;
+    tbb::tick_count rootStart;
+    MainBKTask* root; // root task of this subtree
+    long leafCount; // maximal cliques found by this task, added to its root when it finishes
+    tbb::atomic<long> rootCliques; // maximal cliques of the whole subtree, only used in the root
+    vector<long>* cliqueSizes; // histogram of the cliques found by this task itself; only with --checkpoint or --time-limit
+    // Histogram of the whole subtree, only in the root. It has an entry for every clique size the subtree can
+    // produce, so the tasks add their cliqueSizes with atomic adds when they finish, without a lock.
+    tbb::atomic<long>* rootSizes;
+    int rootSizesLen;
+    tbb::atomic<bool> rootCut; // some branch of the subtree was left out at the --time-limit deadline, only used in the root
 private:
     bool NewGraph;
     MemChunk* sets_chunk;
@@ -122,9 +288,12 @@ private:
 inline MainBKTask:: MainBKTask(Clique *_r, SET_IMPL *_p, SET_IMPL *_x, GraphGuard *gg,
         bool _ir, MainBKTask* _par, bool _ret_clq):
     BKTask(gg), taskSpawnCnt(0), taskLevel(0), R_task(_r), P_task(_p), X_task(_x),
-    cand_task(NULL), NewGraph(_ir), spawnCnt(0), returnClique(_ret_clq), new_vertex(_r->back()),
-    isContinuation(false), newTask(true), sets_chunk(NULL), parent(_par)
+    cand_task(NULL), NewGraph(_ir), spawnCnt(0), returnClique(_ret_clq), new_vertex(_r->back()), second_vertex(-1),
+    isContinuation(false), newTask(true), isSplit(false), hasSplit(false), rootCost(0), eagerSplit(false), rootPsize(0), rootXsize(0),
+    root(_par ? _par->root : this), leafCount(0), cliqueSizes(NULL), rootSizes(NULL), rootSizesLen(0), sets_chunk(NULL), parent(_par)
 {
+    rootCliques = 0;
+    rootCut = false;
     if(CollectMemUsage)
     {
         if(parent) memLogger->addTmpMem(sizeof(MainBKTask), MemType::TASK);
@@ -132,14 +301,24 @@ inline MainBKTask:: MainBKTask(Clique *_r, SET_IMPL *_p, SET_IMPL *_x, GraphGuar
     }
 }
 
-inline MainBKTask::MainBKTask(int vertex, GraphGuard*& g, bool _ir):
+inline MainBKTask::MainBKTask(int vertex, GraphGuard*& g, bool _ir, long _cost, bool _eager, int _second):
     BKTask(g), taskSpawnCnt(0), taskLevel(0), R_task(NULL), P_task(NULL),
     X_task(NULL), cand_task(NULL), NewGraph(_ir), spawnCnt(0), returnClique(false),
-    new_vertex(vertex), isContinuation(false), newTask(true), sets_chunk(NULL), parent(NULL)
+    new_vertex(vertex), second_vertex(_second), isContinuation(false), newTask(true), isSplit(false), hasSplit(false), rootCost(_cost), eagerSplit(_eager),
+    rootPsize(0), rootXsize(0), root(this), leafCount(0), cliqueSizes(NULL), rootSizes(NULL), rootSizesLen(0), sets_chunk(NULL), parent(NULL)
 {
+    rootCliques = 0;
+    rootCut = false;
     if(CollectMemUsage){
         if(parent) memLogger->addTmpMem(sizeof(MainBKTask), MemType::TASK);
         else memLogger->addTmpMem(sizeof(MainBKTask), MemType::ROOT_TASK);
     }
 }
-#endif//_BK_TASK_H_
\ No newline at end of file
+// Makes the task continue the iterations over cand of an already started task
+inline void MainBKTask::resume(SET_IMPL* cand) {
+    cand_task = cand;
+    newTask = false;
+    isSplit = true;
+    set_ref_count(1);
+}
+#endif//_BK_TASK_H_
@@ -0,0 +1,60 @@
+#ifndef _BATCH_H_
+#define _BATCH_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+#include "Graph.h"
+
+using namespace std;
+
+// One graph of a batch: either a path from the manifest or the edge list read from a
+// concatenated multi-graph file
+struct BatchGraph {
+    string name;
+    string path;
+    string text;
+};
+
+struct BatchResult {
+    long vertices, edges;
+    map<int, long> histogram;
+    bool large; // enumerated after the chunk with the parallel task tree
+};
+
+// Enumeration of many small graphs in one process (--batch). The input is a manifest with one
+// graph path per line, or one file in which every graph starts with a "% graph <name>" line.
+// Every graph is loaded, ordered and enumerated by a single task; graphs with at least
+// large_edges edges are enumerated afterwards with the parallel task tree, one at a time.
+// --min-clq and --max-clq apply to every graph.
+class BatchRunner {
+public:
+    BatchRunner(int _nthr, long _large_edges = 100000, size_t _chunk = 4096) :
+        nthr(_nthr), large_edges(_large_edges), chunk(_chunk), graphs(0), large(0), cliques(0) {}
+
+    // Enumerates all graphs of the input, writes their clique histograms to out in input order
+    bool run(string input, ostream& out);
+
+    long getGraphCount() { return graphs; }
+    long getLargeCount() { return large; }
+    long getCliqueCount() { return cliques; }
+private:
+    // Next graphs of the input, at most chunk of them; false at the end of the input
+    bool readChunk(vector<BatchGraph>& batch);
+    Graph* load(const BatchGraph& bg);
+    // Loads one graph and enumerates it sequentially, unless it has at least large_edges edges
+    void runSmall(const BatchGraph& bg, BatchResult& res);
+    void write(ostream& out, const BatchGraph& bg, const BatchResult& res);
+
+    int nthr;
+    long large_edges;
+    size_t chunk;
+    ifstream in;
+    bool manifest;
+    string pending; // "% graph" line that starts the next graph of a concatenated file
+    long graphs, large, cliques;
+};
+
+#endif//_BATCH_H_
@@ -0,0 +1,52 @@
+#ifndef _BENCH_DRIVER_H_
+#define _BENCH_DRIVER_H_
+
+#include <string>
+#include <vector>
+
+#include "Graph.h"
+#include "Autotune.h"
+
+using namespace std;
+
+// One point of the configuration grid: the engine settings, the ordering and the thread count
+struct BenchConfig {
+    TunedSettings settings;
+    int ordering; // as --ord
+    int threads;
+};
+
+struct BenchResult {
+    BenchConfig config;
+    vector<double> times;
+    long peak_kb;
+    unsigned long tasks;
+    long cliques;
+    double mean, stddev, min, max;
+    double speedup; // relative to the same configuration with the fewest threads
+    int base_threads;
+};
+
+// Runs a grid of configurations on a graph that is loaded once, see --bench
+class BenchDriver {
+public:
+    BenchDriver(Graph* g, int _reps = 3, long _sampling_int = 10) : graph(g), reps(_reps), sampling_int(_sampling_int) {}
+
+    // Grid in the form "n=1,2,4;s=0,1,2;thresh=10,30;o=0,1;mem-thresh=20;b=20480;ord=0,1";
+    // parameters that are not given keep their current value
+    bool parseGrid(string spec, int nthr);
+    void run();
+    void writeCsv(string path);
+    void writeJson(string path);
+    void printData();
+private:
+    BenchResult runConfig(const BenchConfig& c);
+
+    Graph* graph;
+    int reps;
+    long sampling_int;
+    vector<BenchConfig> grid;
+    vector<BenchResult> results;
+};
+
+#endif//_BENCH_DRIVER_H_
@@ -0,0 +1,72 @@
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include <tbb/spin_mutex.h>
+#include <tbb/combinable.h>
+
+#include "Graph.h"
+
+using namespace std;
+
+// Periodic checkpoint of a long enumeration (--checkpoint). The root tasks are independent, so
+// the state is the set of finished roots, as a bitmap over the positions in the vertex ordering,
+// and the clique histogram of these roots. Workers only set a bit and add a few counters when a
+// root finishes; a separate thread copies the state and writes it out every interval seconds.
+class Checkpoint {
+public:
+    // roots: the root set of a shard (--shard), NULL for all the vertices
+    Checkpoint(Graph* g, string _path, double _interval = 60, const vector<int>* roots = NULL);
+    ~Checkpoint() { stop(); }
+
+    // Reads the checkpoint of an earlier run on the same graph and settings (--resume)
+    bool load();
+    void start();
+    // Stops the flushing thread and writes the final state
+    void stop();
+
+    // Roots finished by the run that was resumed, they are not spawned again
+    bool isResumed(int position) { return !resumed.empty() && resumed[position]; }
+    // Called by the root task of the vertex when its whole subtree is finished
+    void finishRoot(int vertex, const vector<long>* histogram);
+    // Adds the cliques of the resumed roots to the histogram of the run
+    void addResumed(tbb::combinable<Histogram>& pt_hist);
+
+    long getFinishedRoots() { return finished; }
+    long getResumedRoots() { return resumedRoots; }
+
+    // Identifies the ordered graph and the settings that change the cliques of a root
+    static uint64_t runChecksum(Graph* g);
+    // ... and the roots enumerated by the run, so a checkpoint of one shard is not resumed by another
+    static uint64_t runChecksum(Graph* g, const vector<int>* roots);
+private:
+    void flushing_loop();
+    void flush();
+
+    Graph* graph;
+    string path;
+    double interval;
+    uint64_t checksum;
+
+    tbb::spin_mutex StateMutex; // held by finishRoot and while flush copies the state
+    vector<uint64_t> done;
+    vector<long> histogram;
+    long finished;
+
+    vector<bool> resumed;
+    vector<long> resumedHistogram;
+    long resumedRoots;
+
+    std::thread flusher;
+    std::mutex StopMutex;
+    std::condition_variable stop_cv;
+    bool stopped;
+};
+
+#endif//_CHECKPOINT_H_
@@ -2,8 +2,12 @@
 #define GRAPH_H
 
 #include <vector>
+#include <map>
 #include <tbb/combinable.h>
+#include <tbb/cache_aligned_allocator.h>
+#include <tbb/tick_count.h>
 #include <unordered_map>
+#include <cstdint>
 #include "SetImplementation.h"
 #include "utils.h"
 #include "MemUsageLogger.h"
@@ -15,8 +19,21 @@ extern bool CollectMemUsage;
 
 class BKTask;
 
-// histogram for a single thread
-typedef unordered_map<int, long> Histogram;
+// Clique statistics of a single thread, dense and indexed by the clique size. The arrays are
+// cache line aligned and padded, so the counters of different threads never share a line.
+struct Histogram {
+    void add(int size) {
+        if(size >= (int) counts.size()) resize(size + 1);
+        if(counts[size]++ == 0) first_found[size] = tbb::tick_count::now();
+    }
+    void resize(size_t size);
+
+    vector<long, tbb::cache_aligned_allocator<long>> counts;
+    vector<tbb::tick_count, tbb::cache_aligned_allocator<tbb::tick_count>> first_found;
+
+    static int expected_size; // bound on the clique size + 1, set before the enumeration
+    static tbb::tick_count start; // start of the enumeration
+};
 
 class Graph {
 public:
@@ -32,6 +49,8 @@ public:
 
 	// Get necessary data
 	int getNodeNo() { return nodeNo; }
+	bool hasNode(int node) { return adjList.find(node) != adjList.end(); }
+	long getEdgeNo() { return edgeNo/2; }
 	SET_IMPL* getAdjacentNodes(int node) {	return adjList[node]; }
 	void setAdjacentNodes(int node, SET_IMPL* alist);
 
@@ -42,14 +61,28 @@ public:
 	int getPivot(SET_IMPL*& P, SET_IMPL*& X);
 
 	void initFromFile(string path);
+	// Reads an edge list in the format of initFromFile, without printing
+	void initFromStream(istream& in);
+	// Binary image of the loaded and ordered graph, shared by the processes of a sharded run
+	bool writeSnapshot(string path);
+	bool readSnapshot(string path);
+	// FNV-1a hash of the vertex ordering, identifies the graph and its ordering across processes
+	uint64_t orderingChecksum();
+	// Hashes the adjacency lists, must be called after the graph is loaded and before the enumeration
+	void hashAdjacencyLists();
 
 	int degeneracyOrdering();
+	// Iteratively removes the vertices of degree below k, leaves the k-core; returns the number of removed vertices
+	long pruneToCore(int k);
 
 	// Maximal Clique Enumeration related stuff
 	void BronKerbosch();
-	void BronKerboschDegeneracy(int nthr = 256);
+	void BronKerboschDegeneracy(int nthr = 256, const vector<int>* roots = NULL);
 
     void writeCliqueHist(tbb::combinable<Histogram>& pt_hist);
+    static map<int, long> cliqueHistogram(tbb::combinable<Histogram>& pt_hist);
+    // Seconds from the start of the enumeration until the first clique of every size was found
+    static map<int, double> cliqueFirstFound(tbb::combinable<Histogram>& pt_hist);
 
 	friend class BKTask;
     int mem_type;
@@ -78,6 +111,7 @@ inline Graph::Graph(string path) :
 {
     if(CollectMemUsage) memLogger->addTmpMem(sizeof(*this), mem_type);
 	initFromFile(path);
+	hashAdjacencyLists();
 }
 
 inline Graph::~Graph() {
@@ -0,0 +1,78 @@
+#ifndef _K_CLIQUE_H_
+#define _K_CLIQUE_H_
+
+#include <string>
+#include <fstream>
+
+#include <tbb/combinable.h>
+#include <tbb/spin_mutex.h>
+
+#include "BKTask.h"
+
+using namespace std;
+
+// Counting and listing of all k-cliques (--kclique), not only the maximal ones.
+// The graph is oriented along the vertex ordering, so that every clique is found once, from its
+// first vertex: the candidates of R are the common successors of its vertices.
+class KCliques {
+public:
+    // Orients the graph with nthr threads
+    KCliques(Graph* g, int _k, int nthr, string list_path = "");
+    ~KCliques();
+
+    long run(int nthr);
+    long getCount();
+
+    void addClique(Clique& R);
+    // Adds the cliques R + {u} for every u in P
+    void addCliques(Clique& R, SET_IMPL* P);
+    // List of the successors of the root vertex, owned by the caller
+    SET_IMPL* rootSet(int vertex);
+
+    Graph* graph;
+    Graph* oriented; // adjacency lists hold only the successors in the vertex ordering
+    int k;
+private:
+    void flush(string& buffer);
+
+    tbb::combinable<long> pt_counts;
+    bool listing;
+    tbb::combinable<string> pt_buffers;
+    ofstream list_stream;
+    tbb::spin_mutex list_mutex;
+};
+
+/****************** k-clique tasks ***********************/
+class KCliqueTask : public BKTask {
+public:
+    // Root task of the cliques whose first vertex is vertex
+    KCliqueTask(KCliques* _kc, int vertex, GraphGuard* g) :
+        BKTask(g), kc(_kc), new_vertex(vertex), R_task(NULL), P_task(NULL), isContinuation(false) {}
+    KCliqueTask(KCliques* _kc, Clique* _r, SET_IMPL* _p, GraphGuard* g) :
+        BKTask(g), kc(_kc), new_vertex(_r->back()), R_task(_r), P_task(_p), isContinuation(false) {}
+    virtual ~KCliqueTask() { if(R_task) delete R_task; }
+
+    virtual tbb::task* execute() override;
+protected:
+    virtual tbb::task* SpawnTask() override;
+    void expand(Clique& R, SET_IMPL* P);
+
+    KCliques* kc;
+    int new_vertex;
+    Clique* R_task;
+    SET_IMPL* P_task;
+    bool isContinuation;
+};
+
+class KCliqueRootTask : public BKTask {
+public:
+    KCliqueRootTask(KCliques* _kc, GraphGuard* g) : BKTask(g), kc(_kc), isContinuation(false) {}
+    virtual tbb::task* execute() override { return isContinuation ? NULL : SpawnTask(); }
+protected:
+    virtual tbb::task* SpawnTask() override;
+
+    KCliques* kc;
+    bool isContinuation;
+};
+
+#endif//_K_CLIQUE_H_
@@ -0,0 +1,41 @@
+#ifndef _MAX_CLIQUE_H_
+#define _MAX_CLIQUE_H_
+
+#include <vector>
+#include <iostream>
+
+#include <tbb/atomic.h>
+#include <tbb/spin_mutex.h>
+
+#include "Graph.h"
+#include "UnrolledList.h"
+
+using namespace std;
+
+// Maximum clique search (--max-clique). The enumeration keeps running on the parallel task
+// tree, but every subtree that cannot beat the best clique found so far is cut (see SearchBound).
+class MaxClique {
+public:
+    MaxClique(bool _coloring = false) : coloring(_coloring), best_size(0) {}
+
+    // Greedy clique from every vertex, gives the search a good starting bound
+    void heuristic(Graph* graph, int nthr);
+    // Called at every maximal clique, keeps it if it is larger than the best one
+    void offer(UnrolledList& R);
+    // Greedy colouring bound: true if no clique in P can extend R beyond the best clique
+    bool colorPrunes(Graph* graph, int r_size, SET_IMPL* P);
+
+    int getSize() { return best_size; }
+    const vector<int>& getWitness() { return witness; }
+    // complete: false if the search was cut (--time-limit), the size is then a lower bound
+    void printData(ostream& out = cout, bool complete = true);
+private:
+    void update(const vector<int>& clique);
+
+    bool coloring;
+    tbb::atomic<int> best_size;
+    vector<int> witness;
+    tbb::spin_mutex witness_mutex;
+};
+
+#endif//_MAX_CLIQUE_H_
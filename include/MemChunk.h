@@ -5,6 +5,7 @@
 #include <list>
 #include "utils.h"
 #include "MemUsageLogger.h"
+#include "AlgoStats.h"
 
 extern MemUsageLogger *memLogger;
 const uint32_t DEF_BLOCK_SIZE=20480;
@@ -29,6 +30,7 @@ private:
 inline char* MemChunk::get_address(size_t size){
     uint32_t mask = L2_CACHE_LINE-1; // Align on a cache line
     uint32_t index_increment = (size & ~mask) + (!!(size & mask) << 6); // 2^6 = 64
+    ALGO_STAT_INC(STAT_CHUNK_ALLOCS);
     if((number_of_blocks == 0) || (free_index + index_increment >= dynamic_block_size)){
         void *ptr = NULL;
         int alloc_size = index_increment > dynamic_block_size ? index_increment : dynamic_block_size;
@@ -36,6 +38,7 @@ inline char* MemChunk::get_address(size_t size){
         if (memLogger) memLogger->addTmpMem(alloc_size * sizeof(uint8_t));
         dynamic_block_list.push_back(std::make_pair((uint8_t *) ptr, alloc_size));
         number_of_blocks++;
+        ALGO_STAT_INC(STAT_CHUNK_BLOCKS);
         free_index = 0;
     }
     uint8_t* pointer = dynamic_block_list.back().first + free_index;
@@ -6,11 +6,15 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include <tbb/tick_count.h>
-#include <tbb/combinable.h>
 #include <tbb/spin_mutex.h>
-#include <tbb/atomic.h>
+#include <tbb/cache_aligned_allocator.h>
 
 using namespace std;
 
@@ -22,120 +26,152 @@ enum MemType { SET = 0, SUBGRAPH, GRAPH, CLIQUE, TASK, ROOT_SET, ROOT_SUBGRAPH,
 const std::string TYPE_NAMES[] = {"Sets", "Subgraphs", "Graph", "Cliques", "Tasks",
                                   "RootSets","RootSubgraphs", "RootCliques", "RootTasks", "Other"};
 
+// Memory usage counters of a single thread. Only the owning thread writes them, so updates are
+// plain relaxed load/store pairs; the sampling thread reads them without any synchronization.
+// alignas is not honoured by new before C++17, the counters are allocated with
+// tbb::cache_aligned_allocator so that no two threads share a cache line.
+struct alignas(64) MemUsageCounters {
+    MemUsageCounters() : allocations(0) { for(int i = 0; i < MemType::NUM_OF_TYPES; i++) usage[i] = 0; }
+    std::atomic<long> usage[MemType::NUM_OF_TYPES];
+    std::atomic<long> allocations;
+};
+
 class MemUsageLogger {
 public:
-    MemUsageLogger(string out_file_name, long _si = 10000) :
-        tmp_type_usage_pt(MemType::NUM_OF_TYPES), peak_type_usage(MemType::NUM_OF_TYPES),
-        tmp_combine_semaphore(false), peak_usage(0),
-        t_start(tbb::tick_count::now()), sampling_interval(_si),
-        mem_log_stream(out_file_name)
+    // The sampling interval is in milliseconds; a non-positive interval disables the sampling
+    // thread and the csv output, and leaves only the counting of allocations.
+    MemUsageLogger(string out_file_name, long _si = 10) :
+        peak_usage(0), peak_type_usage(MemType::NUM_OF_TYPES, 0),
+        generation(next_generation()), t_start(tbb::tick_count::now()), sampling_interval(_si),
+        stopped(false), mem_log_stream(out_file_name)
     {
         mem_log_stream << "Timestamp, Total";
         for(int i = 0; i < MemType::NUM_OF_TYPES; i++)
             mem_log_stream << ", " << TYPE_NAMES[i];
         mem_log_stream << endl;
+        if(sampling_interval > 0) sampler = std::thread([this]() { sampling_loop(); });
     }
 
-    ~MemUsageLogger() { }
+    ~MemUsageLogger() {
+        stop();
+        tbb::cache_aligned_allocator<MemUsageCounters> alloc;
+        for(auto counters : pt_counters) { counters->~MemUsageCounters(); alloc.deallocate(counters, 1); }
+    }
 
     void addTmpMem(long mem, int type = MemType::OTHER);
     void delTmpMem(long mem, int type = MemType::OTHER);
     void printData();
+    void stop();
+
+    long getPeakUsage() { return peak_usage; }
+    long getPeakUsage(int type) { return peak_type_usage[type]; }
 private:
-    void add_memory_usage(long mem, tbb::combinable<long>& pt_usage);
-    void del_memory_usage(long mem, tbb::combinable<long>& pt_usage);
+    MemUsageCounters& local_counters();
+    MemUsageCounters* register_thread();
+    void sampling_loop();
+    void sample(bool write);
+    static long next_generation() { static std::atomic<long> gen(0); return ++gen; }
 
-    void update_peak_usage();
-    long combine_mem_usage_data(tbb::combinable<long>& pt_usage);
+    // Registered per-thread counters, only locked on registration and by the sampling thread
+    MemUsageMutexType CountersMutex;
+    std::vector<MemUsageCounters*> pt_counters;
 
-    MemUsageMutexType MemUsageMutex;
-    tbb::combinable<long> total_usage_pt, tmp_usage_pt, allocation_num_pt;
     long peak_usage;
-
-    std::vector<tbb::combinable<long>> tmp_type_usage_pt;
     std::vector<long> peak_type_usage;
-    tbb::atomic<bool> tmp_combine_semaphore;
-    tbb::combinable<unsigned int> pt_seed;
+    const long generation; // distinguishes the thread local counters of consecutive loggers
 
     tbb::tick_count t_start;
     long sampling_interval;
+    std::thread sampler;
+    std::mutex StopMutex;
+    std::condition_variable stop_cv;
+    bool stopped;
     ofstream mem_log_stream;
 };
 
-inline void MemUsageLogger::addTmpMem(long mem, int type) {
-    while(tmp_combine_semaphore);
-    add_memory_usage(mem, tmp_usage_pt);
-    add_memory_usage(mem, tmp_type_usage_pt[type]);
-    update_peak_usage();
-    bool exists = false;
-    auto& local_cnt = allocation_num_pt.local(exists);
-    if(!exists) local_cnt = 0;
-    local_cnt++;
+inline MemUsageCounters& MemUsageLogger::local_counters() {
+    static thread_local MemUsageCounters* tl_counters = NULL;
+    static thread_local long tl_generation = 0;
+    if(tl_generation != generation) {
+        tl_counters = register_thread();
+        tl_generation = generation;
+    }
+    return *tl_counters;
 }
 
-inline void MemUsageLogger::delTmpMem(long mem, int type) {
-    while(tmp_combine_semaphore);
-    del_memory_usage(mem, tmp_usage_pt);
-    del_memory_usage(mem, tmp_type_usage_pt[type]);
-    update_peak_usage();
+inline MemUsageCounters* MemUsageLogger::register_thread() {
+    MemUsageCounters* counters = new(tbb::cache_aligned_allocator<MemUsageCounters>().allocate(1)) MemUsageCounters;
+    MemUsageMutexType::scoped_lock lock(CountersMutex);
+    pt_counters.push_back(counters);
+    return counters;
 }
 
-inline void MemUsageLogger::update_peak_usage() {
-    bool exists = false;
-    auto& local_seed = pt_seed.local(exists);
-    if(!exists) local_seed = time(NULL);
-
-    // Negative sampling interval blocks printing and enables only counting the number of allocations
-    if((sampling_interval > 0) && (rand_r(&local_seed) % sampling_interval == sampling_interval-1) ) {
-        MemUsageMutexType::scoped_lock lock(MemUsageMutex);
-        while (tmp_combine_semaphore);
-        tmp_combine_semaphore = true;
+inline void MemUsageLogger::addTmpMem(long mem, int type) {
+    MemUsageCounters& c = local_counters();
+    c.usage[type].store(c.usage[type].load(std::memory_order_relaxed) + mem, std::memory_order_relaxed);
+    c.allocations.store(c.allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
 
-        long tmp_usage = combine_mem_usage_data(tmp_usage_pt);
+inline void MemUsageLogger::delTmpMem(long mem, int type) {
+    MemUsageCounters& c = local_counters();
+    c.usage[type].store(c.usage[type].load(std::memory_order_relaxed) - mem, std::memory_order_relaxed);
+}
 
-        if (tmp_usage > peak_usage) {
-            peak_usage = tmp_usage;
+inline void MemUsageLogger::sample(bool write) {
+    long type_usage[MemType::NUM_OF_TYPES] = {0};
+    {
+        MemUsageMutexType::scoped_lock lock(CountersMutex);
+        for(auto counters : pt_counters)
             for(int i = 0; i < MemType::NUM_OF_TYPES; i++)
-                peak_type_usage[i] = combine_mem_usage_data(tmp_type_usage_pt[i]);
-        }
-
-        auto tstamp = tbb::tick_count::now();
-
-        mem_log_stream << (tstamp - t_start).seconds() << ", " << tmp_usage/1024.0;
-        for(int i = 0; i < MemType::NUM_OF_TYPES; i++)
-            mem_log_stream << ", " << combine_mem_usage_data(tmp_type_usage_pt[i])/1024.0;
-        mem_log_stream << endl;
+                type_usage[i] += counters->usage[i].load(std::memory_order_relaxed);
+    }
+    long tmp_usage = 0;
+    for(int i = 0; i < MemType::NUM_OF_TYPES; i++) tmp_usage += type_usage[i];
 
-        tmp_combine_semaphore = false;
+    if (tmp_usage > peak_usage) {
+        peak_usage = tmp_usage;
+        for(int i = 0; i < MemType::NUM_OF_TYPES; i++) peak_type_usage[i] = type_usage[i];
     }
-}
+    if(!write) return;
 
-inline void MemUsageLogger::add_memory_usage(long mem, tbb::combinable<long>& pt_usage) {
-    bool exists = false;
-    auto& local_usage = pt_usage.local(exists);
-    if(!exists) local_usage = 0;
-    local_usage += mem;
+    auto tstamp = tbb::tick_count::now();
+    mem_log_stream << (tstamp - t_start).seconds() << ", " << tmp_usage/1024.0;
+    for(int i = 0; i < MemType::NUM_OF_TYPES; i++)
+        mem_log_stream << ", " << type_usage[i]/1024.0;
+    mem_log_stream << "\n";
 }
 
-inline void MemUsageLogger::del_memory_usage(long mem, tbb::combinable<long>& pt_usage) {
-    bool exists = false;
-    auto& local_usage = pt_usage.local(exists);
-    if(!exists) local_usage = 0;
-    local_usage -= mem;
+inline void MemUsageLogger::sampling_loop() {
+    std::unique_lock<std::mutex> lock(StopMutex);
+    while(!stopped) {
+        stop_cv.wait_for(lock, std::chrono::milliseconds(sampling_interval));
+        if(stopped) break;
+        sample(true);
+    }
 }
 
-inline long MemUsageLogger::combine_mem_usage_data(tbb::combinable<long>& pt_usage) {
-    long total_mem_usage = 0;
-    pt_usage.combine_each([&](long sum) { total_mem_usage += sum; });
-    return total_mem_usage;
+inline void MemUsageLogger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(StopMutex);
+        if(stopped) return;
+        stopped = true;
+    }
+    stop_cv.notify_all();
+    if(sampler.joinable()) sampler.join();
+    sample(sampling_interval > 0);
+    mem_log_stream.flush();
 }
 
 inline void MemUsageLogger::printData(){
-    long total_usage =combine_mem_usage_data(total_usage_pt);
-    long allocation_num =combine_mem_usage_data(allocation_num_pt);
+    stop();
+    long allocation_num = 0;
+    {
+        MemUsageMutexType::scoped_lock lock(CountersMutex);
+        for(auto counters : pt_counters) allocation_num += counters->allocations.load(std::memory_order_relaxed);
+    }
     cout << "Peak memory usage: " << peak_usage/1024 << " KB" << endl;
     for(int i = 0; i < MemType::NUM_OF_TYPES; i++)
         cout << "   "  << TYPE_NAMES[i] << " :       " << peak_type_usage[i]/1024 << " KB" << endl;
     cout << "Number of allocations: " << allocation_num << endl;
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,68 @@
+#ifndef _PERF_COUNTERS_H_
+#define _PERF_COUNTERS_H_
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include <tbb/spin_mutex.h>
+
+using namespace std;
+
+enum PerfEvent { PERF_CYCLES = 0, PERF_INSTRUCTIONS, PERF_LLC_MISSES, PERF_DTLB_MISSES, PERF_BRANCH_MISSES,
+        NUM_OF_PERF_EVENTS };
+const std::string PERF_EVENT_NAMES[] = {"cycles", "instructions", "LLC-misses", "dTLB-misses", "branch-misses"};
+
+// Hardware counters of a single thread, opened with perf_event_open. Events that cannot be
+// opened (no permission, no PMU in a VM) are left at -1 and reported as n/a.
+struct PerfCounterGroup {
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+    void read(long long* values);
+    bool any_open();
+    int fds[NUM_OF_PERF_EVENTS];
+};
+
+struct PerfPhase {
+    string name;
+    long long total[NUM_OF_PERF_EVENTS]; // -1 if not available
+    vector<vector<long long>> workers;
+};
+
+// Counts the hardware events of a phase. Single threaded phases are counted on the calling thread,
+// during the enumeration every worker attaches its own counters on its first task.
+class PerfCounters {
+public:
+    PerfCounters() : generation(0), active(false), warned(false) {}
+    ~PerfCounters() { closeGroups(); }
+
+    void beginPhase();
+    void endPhase(string name, bool per_worker = false);
+    void attach_thread();
+    const vector<PerfPhase>& getPhases() { return phases; }
+private:
+    void closeGroups();
+    void print(string label, const long long* values);
+
+    typedef tbb::spin_mutex PerfMutexType;
+    PerfMutexType GroupsMutex;
+    vector<PerfCounterGroup*> groups;
+    vector<PerfPhase> phases; // phases with at least one available counter
+
+    std::atomic<long> generation;
+    std::atomic<bool> active;
+    bool warned;
+};
+
+inline void PerfCounters::attach_thread() {
+    static thread_local long tl_generation = 0;
+    if(!active.load(std::memory_order_relaxed)) return;
+    long gen = generation.load(std::memory_order_relaxed);
+    if(tl_generation == gen) return;
+    tl_generation = gen;
+    PerfCounterGroup* group = new PerfCounterGroup;
+    PerfMutexType::scoped_lock lock(GroupsMutex);
+    groups.push_back(group);
+}
+
+#endif//_PERF_COUNTERS_H_
@@ -0,0 +1,69 @@
+#ifndef _PROGRESS_H_
+#define _PROGRESS_H_
+
+#include <string>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <tbb/atomic.h>
+#include <tbb/spin_mutex.h>
+#include <tbb/tick_count.h>
+
+#include "Graph.h"
+
+using namespace std;
+
+class RootIterBKTask;
+
+// Periodic progress line (--progress) and deadline (--time-limit) of the enumeration. Only the
+// root tasks report to it, when their whole subtree is finished; a separate thread prints the
+// progress and raises TimeBudget::expired at the deadline.
+class Progress {
+public:
+    // Intervals in seconds, a non-positive interval or limit turns the line or the deadline off
+    Progress(double _interval, double _time_limit) : interval(_interval), time_limit(_time_limit), graph(NULL),
+        pendingRoots(NULL), stopped(false) {
+        totalRoots = 0; totalCost = 0; doneRoots = 0; doneCost = 0; cliques = 0;
+    }
+    ~Progress() { stop(); if(pendingRoots) delete[] pendingRoots; }
+
+    void start();
+    void stop();
+
+    // Called by the task spawning the roots, once they are known (positions in the vertex ordering)
+    void setRoots(RootIterBKTask* task, Graph* g, const vector<int>& roots);
+    // Called by a root task when its subtree is done; not finished if the deadline cut it.
+    // histogram: cliques of the root by size, kept only with a time limit
+    void finishRoot(int vertex, int second_vertex, long root_cliques, bool finished, const vector<long>* histogram);
+
+    bool hasTimeLimit() { return time_limit > 0; }
+
+    long getTotalRoots() { return totalRoots; }
+    long getFinishedRoots() { return doneRoots; }
+    // Vertices whose roots all finished
+    vector<int> getFinishedVertices();
+    // Clique histogram of the finished roots only, without the cliques of the roots cut by the deadline
+    map<int, long> getFinishedHistogram();
+    void printLine();
+private:
+    void loop();
+
+    double interval, time_limit;
+    tbb::tick_count t_start;
+    Graph* graph;
+    vector<long> costs; // by position, 0 for the vertices that are not roots
+    tbb::atomic<int>* pendingRoots; // by position, root tasks of the vertex that have not finished
+    tbb::atomic<long> totalRoots, totalCost, doneRoots, doneCost, cliques;
+    tbb::spin_mutex HistogramMutex;
+    vector<long> finishedHistogram;
+
+    std::thread printer;
+    std::mutex StopMutex;
+    std::condition_variable stop_cv;
+    bool stopped;
+};
+
+#endif//_PROGRESS_H_
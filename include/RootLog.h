@@ -0,0 +1,127 @@
+#ifndef _ROOT_LOG_H_
+#define _ROOT_LOG_H_
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <tbb/combinable.h>
+
+using namespace std;
+
+// Per-root record: estimated cost next to the measured runtime of the whole root subtree
+struct RootRecord {
+    int vertex, second;
+    long cost;
+    int p_size, x_size;
+    double runtime;
+    long cliques;
+};
+
+class RootLog {
+public:
+    RootLog(string out_file_name) : root_log_stream(out_file_name) {}
+    ~RootLog() {}
+
+    void addRoot(int vertex, int second, long cost, int p_size, int x_size, double runtime, long cliques);
+    void writeData();
+private:
+    static vector<double> ranks(const vector<double>& values);
+
+    tbb::combinable<vector<RootRecord>> pt_records;
+    ofstream root_log_stream;
+};
+
+inline void RootLog::addRoot(int vertex, int second, long cost, int p_size, int x_size, double runtime, long cliques) {
+    RootRecord rec = {vertex, second, cost, p_size, x_size, runtime, cliques};
+    pt_records.local().push_back(rec);
+}
+
+inline vector<double> RootLog::ranks(const vector<double>& values) {
+    vector<int> idx(values.size());
+    for(size_t i = 0; i < idx.size(); i++) idx[i] = i;
+    sort(idx.begin(), idx.end(), [&](int a, int b) { return values[a] < values[b]; });
+    vector<double> rank(values.size());
+    for(size_t i = 0; i < idx.size(); ) {
+        size_t j = i;
+        while(j + 1 < idx.size() && values[idx[j+1]] == values[idx[i]]) j++;
+        for(size_t k = i; k <= j; k++) rank[idx[k]] = (i + j) / 2.0; // average rank for ties
+        i = j + 1;
+    }
+    return rank;
+}
+
+inline void RootLog::writeData() {
+    vector<RootRecord> records;
+    pt_records.combine_each([&](const vector<RootRecord>& local) {
+        records.insert(records.end(), local.begin(), local.end());
+    });
+    sort(records.begin(), records.end(), [](const RootRecord& a, const RootRecord& b) { return a.runtime > b.runtime; });
+
+    root_log_stream << "Vertex, Second, Cost, P, X, Runtime, Cliques" << endl;
+    for(auto& rec : records)
+        root_log_stream << rec.vertex << ", " << rec.second << ", " << rec.cost << ", " << rec.p_size << ", " << rec.x_size << ", "
+                        << rec.runtime << ", " << rec.cliques << "\n";
+    root_log_stream.flush();
+
+    // Spearman rank correlation between the estimated cost and the measured runtime
+    if(records.size() < 2) return;
+    vector<double> cost(records.size()), time(records.size());
+    for(size_t i = 0; i < records.size(); i++) { cost[i] = records[i].cost; time[i] = records[i].runtime; }
+    vector<double> rc = ranks(cost), rt = ranks(time);
+    double mean = (records.size() - 1) / 2.0, cov = 0, var_c = 0, var_t = 0;
+    for(size_t i = 0; i < records.size(); i++) {
+        cov += (rc[i] - mean) * (rt[i] - mean);
+        var_c += (rc[i] - mean) * (rc[i] - mean);
+        var_t += (rt[i] - mean) * (rt[i] - mean);
+    }
+    double corr = (var_c > 0 && var_t > 0) ? cov / sqrt(var_c * var_t) : 0;
+    cout << "Root cost estimate vs runtime rank correlation: " << corr << endl;
+    cout << "Slowest root: " << records[0].vertex << " (" << records[0].runtime << "s, cost " << records[0].cost << ")" << endl;
+}
+
+/****************** Root size distribution ***********************/
+// Log2-bucketed distribution of the initial |P| and |X| of the root tasks
+class RootSizeStats {
+public:
+    RootSizeStats() : pt_p_hist(empty_hist), pt_x_hist(empty_hist) {}
+    void addRoot(int p_size, int x_size) {
+        pt_p_hist.local()[bucket(p_size)]++;
+        pt_x_hist.local()[bucket(x_size)]++;
+    }
+    void printData(string mode);
+private:
+    static const int NUM_OF_BUCKETS = 33;
+    static vector<long> empty_hist() { return vector<long>(NUM_OF_BUCKETS, 0); }
+    static int bucket(int size) { return size == 0 ? 0 : 32 - __builtin_clz(size); }
+    static vector<long> combine(tbb::combinable<vector<long>>& pt_hist);
+
+    tbb::combinable<vector<long>> pt_p_hist, pt_x_hist;
+};
+
+inline vector<long> RootSizeStats::combine(tbb::combinable<vector<long>>& pt_hist) {
+    vector<long> hist = empty_hist();
+    pt_hist.combine_each([&](const vector<long>& local) {
+        for(int i = 0; i < NUM_OF_BUCKETS; i++) hist[i] += local[i];
+    });
+    return hist;
+}
+
+inline void RootSizeStats::printData(string mode) {
+    vector<long> p_hist = combine(pt_p_hist), x_hist = combine(pt_x_hist);
+    long roots = 0;
+    int last = 0;
+    for(int i = 0; i < NUM_OF_BUCKETS; i++) {
+        roots += p_hist[i];
+        if(p_hist[i] || x_hist[i]) last = i;
+    }
+    cout << "# Root task size distribution (" << mode << " roots): " << roots << " roots" << endl;
+    cout << "# size_range, roots_by_P, roots_by_X" << endl;
+    for(int i = 0; i <= last; i++) {
+        long lo = i == 0 ? 0 : (1L << (i-1)), hi = i == 0 ? 0 : (1L << i) - 1;
+        cout << lo << "-" << hi << ", " << p_hist[i] << ", " << x_hist[i] << endl;
+    }
+}
+#endif//_ROOT_LOG_H_
@@ -0,0 +1,43 @@
+#ifndef _RUN_REPORT_H_
+#define _RUN_REPORT_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+
+#include "MemUsageLogger.h"
+#include "PerfCounters.h"
+
+using namespace std;
+
+// Collects the configuration, timings and statistics of a run and writes them as one json document
+class RunReport {
+public:
+    RunReport(string _out_file_name) : out_file_name(_out_file_name) {}
+
+    void set(string section, string key, long value) { setRaw(section, key, to_string(value)); }
+    void set(string section, string key, int value) { setRaw(section, key, to_string(value)); }
+    void set(string section, string key, unsigned int value) { setRaw(section, key, to_string(value)); }
+    void set(string section, string key, unsigned long value) { setRaw(section, key, to_string(value)); }
+    void set(string section, string key, bool value) { setRaw(section, key, value ? "true" : "false"); }
+    void set(string section, string key, double value);
+    void set(string section, string key, string value) { setRaw(section, key, quote(value)); }
+    void set(string section, string key, const char* value) { set(section, key, string(value)); }
+    void setRaw(string section, string key, string json);
+
+    void addHardwareInfo();
+    void addCliqueHistogram(const map<int, long>& histogram, const map<int, double>& first_found = map<int, double>());
+    void addMemoryUsage(MemUsageLogger* logger);
+    void addPerfCounters(PerfCounters* counters);
+    void addAlgoStats();
+    void writeData();
+
+    static string quote(const string& s);
+private:
+    typedef vector<pair<string, string>> Section;
+    vector<pair<string, Section>> sections; // kept in the order of insertion
+    string out_file_name;
+};
+
+#endif//_RUN_REPORT_H_
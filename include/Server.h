@@ -0,0 +1,48 @@
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include "Graph.h"
+#include "KClique.h"
+#include "Autotune.h"
+
+using namespace std;
+
+// Keeps a loaded, ordered and hashed graph in memory and answers requests on a Unix domain
+// socket (--serve). A request is one line, the command followed by command line style options;
+// the response is written back and the connection is closed. Requests are served one at a time,
+// on a task scheduler that stays initialized with the -n threads of the server.
+//
+//   enumerate [-s S] [--thresh T] [-o] [--mem-thresh M] [-b B] [--min-clq k]
+//   query <vertices>
+//   topk <K> [options of enumerate]
+//   maxclique [--color-bound] [options of enumerate]
+//   kclique <k>
+//   info
+//   shutdown
+class MceServer {
+public:
+    MceServer(Graph* g, int _nthr, string _socket_path) : graph(g), nthr(_nthr), socket_path(_socket_path), kcliques(NULL) {}
+    ~MceServer() { if(kcliques) delete kcliques; }
+
+    // Serves requests until a shutdown request, returns false if the socket cannot be opened
+    bool run();
+    // Handles one request and returns the response
+    string handle(const string& request, bool& shutdown);
+private:
+    // Applies the engine options of a request on top of the settings of the server
+    void applyOptions(char** begin, char** end);
+    // One enumeration with the current settings, writes the clique histogram
+    void enumerate(ostream& out);
+
+    Graph* graph;
+    int nthr;
+    string socket_path;
+    TunedSettings settings; // of the server, restored after every request
+    KCliques* kcliques; // oriented graph, built by the first kclique request
+};
+
+#endif//_SERVER_H_
@@ -0,0 +1,37 @@
+#ifndef _SHARD_H_
+#define _SHARD_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+#include "Graph.h"
+
+using namespace std;
+
+// Root vertices of one of several processes enumerating the same graph (--shard i/N). All
+// processes compute the same assignment: the roots, heaviest first by the cost |P| * (|X| + 1)
+// of their root sets, go to the shard with the smallest total cost so far. Every shard writes a partial result file,
+// which --merge combines.
+class ShardPlan {
+public:
+    ShardPlan(Graph* g, int _index, int _count) : graph(g), index(_index), count(_count), cost(0), totalCost(0) {}
+
+    // "i/N" with 0 <= i < N
+    static bool parse(string spec, int& index, int& count);
+    void assign(int nthr);
+    const vector<int>& getRoots() { return roots; }
+
+    void writeResult(string path, const map<int, long>& histogram, double runtime);
+    // Checks that the files are the N shards of one run and prints their combined histogram;
+    // fails if one is missing, unless partial is set (--merge-partial)
+    static bool merge(const vector<string>& paths, ostream& out, bool partial = false);
+private:
+    Graph* graph;
+    int index, count;
+    vector<int> roots; // positions in the vertex ordering
+    long cost, totalCost;
+};
+
+#endif//_SHARD_H_
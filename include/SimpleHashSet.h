@@ -9,6 +9,7 @@
 #include "SimpleHashTable.h"
 #include "MemChunk.h"
 #include "utils.h"
+#include "AlgoStats.h"
 
 extern MemUsageLogger *memLogger;
 
@@ -109,6 +110,9 @@ inline SimpleHashSet* SimpleHashSet::intersect(SimpleHashSet *other, MemChunk* c
     if(!other) return NULL;
     auto *newSet = create_set(chunk, type);
     this->for_each([&](int node) { if(other->contains(node)) newSet->elems.push_back(node); });
+    ALGO_STAT_INC(STAT_INTERSECTIONS);
+    ALGO_STAT_HIST(HIST_INTERSECT_IN, size()); ALGO_STAT_HIST(HIST_INTERSECT_HASHED, other->size());
+    ALGO_STAT_HIST(HIST_INTERSECT_OUT, newSet->size());
     return newSet;
 }
 #else
@@ -133,6 +137,9 @@ inline SimpleHashSet* SimpleHashSet::intersect(SimpleHashSet *other, MemChunk* c
         }
         pom = pom->next;
     }
+    ALGO_STAT_INC(STAT_INTERSECTIONS);
+    ALGO_STAT_HIST(HIST_INTERSECT_IN, size()); ALGO_STAT_HIST(HIST_INTERSECT_HASHED, other->size());
+    ALGO_STAT_HIST(HIST_INTERSECT_OUT, newSet->size());
     return newSet;
 }
 #endif
@@ -7,6 +7,7 @@
 
 #include "MemChunk.h"
 #include "utils.h"
+#include "AlgoStats.h"
 
 extern MemUsageLogger *memLogger;
 
@@ -101,13 +102,15 @@ inline bool SimpleHashTable::contains(KeyType el, int pos) {
     if(!size()) return false;
     pos = pos == -1 ? hashFunction(el) : pos;
     int found = false;
-    for(size_t i = 0; i < number_of_attempts; i++) {
+    size_t i = 0;
+    for(; i < number_of_attempts; i++) {
         if(array[pos] == el) {
             found = true; break;
         }
         if(array[pos] == -1) break;
         pos = (pos + 1) % capacity;
     }
+    ALGO_STAT_HIST(HIST_PROBE_LENGTH, i + 1);
     return found;
 }
 #else
@@ -116,7 +119,8 @@ inline bool SimpleHashTable::contains(KeyType el, int pos) {
     pos = pos == -1 ? hashFunction(el) : pos;
     __m512i el_vec = _mm512_set1_epi32(el);
     bool found = false;
-    for(size_t i = 0; i < number_of_attempts/VECTOR_SIZE + 1; i++) {
+    size_t i = 0;
+    for(; i < number_of_attempts/VECTOR_SIZE + 1; i++) {
         __m512i elem_vec = _mm512_maskz_loadu_epi32(0xFFFF,(void*)(array + pos));
         __mmask16 el_cmp_mask = _mm512_cmpeq_epi32_mask(elem_vec, el_vec);
         __mmask16 empty_cmp_mask = _mm512_cmpeq_epi32_mask(elem_vec, empty_vec);
@@ -127,6 +131,7 @@ inline bool SimpleHashTable::contains(KeyType el, int pos) {
         pos = pos + VECTOR_SIZE;
         if(pos > capacity) pos = 0;
     }
+    ALGO_STAT_HIST(HIST_PROBE_LENGTH, i + 1);
     return found;
 }
 
@@ -137,9 +142,11 @@ inline __mmask16 SimpleHashTable::vector_lookup(__m512i el_vector, __mmask16 mas
     __mmask16 el_cmp_mask = _mm512_mask_cmpeq_epi32_mask(mask, el_vector, fetched_vec);
     __mmask16 empty_cmp_mask = _mm512_cmpeq_epi32_mask(empty_vec, fetched_vec);
     __mmask16 done_mask = el_cmp_mask | empty_cmp_mask | (~mask);
+    ALGO_STAT_ADD(STAT_LOOKUPS, _mm_popcnt_u32(mask));
     for(int i = 0; i < VECTOR_SIZE; i++) {
         __mmask16 tmp_mask = 1 << i;
         if((~done_mask) & tmp_mask) {
+            ALGO_STAT_INC(STAT_SCALAR_FALLBACKS);
             bool found = contains( ((KeyType*)(&el_vector))[i], ((int*)(&rem_vec))[i] );
             el_cmp_mask |= found << i;
         }
@@ -190,6 +197,7 @@ inline bool SimpleHashTable::hopscotchTryInsert(KeyType el) {
 }
 
 inline void SimpleHashTable::hopscotchReconstruct() {
+    ALGO_STAT_INC(STAT_HS_RECONSTRUCTS);
     KeyType* oldArray = array;
     int old_capac = phys_capacity;
     reserve(capacity);
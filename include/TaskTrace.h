@@ -0,0 +1,80 @@
+#ifndef _TASK_TRACE_H_
+#define _TASK_TRACE_H_
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include <tbb/tick_count.h>
+#include <tbb/spin_mutex.h>
+
+using namespace std;
+
+enum TraceType { TRACE_TASK = 0, TRACE_ROOT_TASK, TRACE_SEQUENTIAL, TRACE_SUBGRAPH, TRACE_SPAWN_ROOTS,
+        TRACE_ROOT_SUBTREE, NUM_OF_TRACE_TYPES };
+const std::string TRACE_NAMES[] = {"MainBKTask", "RootTask", "Sequential", "Subgraph", "SpawnRoots", "Root"};
+
+struct TraceRecord {
+    double begin, end; // microseconds since the start of the trace
+    int type;
+    int arg, arg2; // vertices of the task, -1 if unused
+};
+
+// Fixed size ring buffer of the events of one worker, keeps the most recent events
+struct TraceBuffer {
+    TraceBuffer(int _tid, size_t capacity) : records(capacity), next(0), wrapped(false), tid(_tid) {}
+    void push(const TraceRecord& rec) {
+        records[next] = rec;
+        if(++next == records.size()) { next = 0; wrapped = true; }
+    }
+    vector<TraceRecord> records;
+    size_t next;
+    bool wrapped;
+    int tid;
+};
+
+// Records begin/end events per worker into thread-local ring buffers and writes them
+// in the Chrome trace event format (chrome://tracing, https://ui.perfetto.dev)
+class TaskTracer {
+public:
+    TaskTracer(string _out_file_name, size_t _buffer_size = 65536) :
+        out_file_name(_out_file_name), buffer_size(_buffer_size),
+        generation(next_generation()), t_start(tbb::tick_count::now()) {}
+    ~TaskTracer() { for(auto buffer : buffers) delete buffer; }
+
+    tbb::tick_count now() { return tbb::tick_count::now(); }
+    void record(int type, tbb::tick_count begin, int arg = -1, int arg2 = -1);
+    void writeData();
+private:
+    TraceBuffer& local_buffer();
+    double timestamp(tbb::tick_count t) { return (t - t_start).seconds() * 1e6; }
+    static long next_generation() { static std::atomic<long> gen(0); return ++gen; }
+
+    typedef tbb::spin_mutex TraceMutexType;
+    TraceMutexType BuffersMutex;
+    vector<TraceBuffer*> buffers;
+
+    string out_file_name;
+    size_t buffer_size;
+    const long generation; // distinguishes the thread local buffers of consecutive tracers
+    tbb::tick_count t_start;
+};
+
+inline TraceBuffer& TaskTracer::local_buffer() {
+    static thread_local TraceBuffer* tl_buffer = NULL;
+    static thread_local long tl_generation = 0;
+    if(tl_generation != generation) {
+        TraceMutexType::scoped_lock lock(BuffersMutex);
+        tl_buffer = new TraceBuffer(buffers.size(), buffer_size);
+        buffers.push_back(tl_buffer);
+        tl_generation = generation;
+    }
+    return *tl_buffer;
+}
+
+inline void TaskTracer::record(int type, tbb::tick_count begin, int arg, int arg2) {
+    TraceRecord rec = {timestamp(begin), timestamp(now()), type, arg, arg2};
+    local_buffer().push(rec);
+}
+
+#endif//_TASK_TRACE_H_
@@ -0,0 +1,37 @@
+#ifndef _TOP_K_CLIQUES_H_
+#define _TOP_K_CLIQUES_H_
+
+#include <string>
+#include <vector>
+#include <queue>
+
+#include <tbb/combinable.h>
+
+#include "UnrolledList.h"
+
+using namespace std;
+
+// The K largest maximal cliques (--top-k). Every worker keeps a min-heap of at most K cliques;
+// once a heap is full, its smallest clique is a lower bound on the K-th largest one, and the
+// search bound is raised past it so that no subtree that cannot beat it is explored.
+class TopKCliques {
+public:
+    TopKCliques(int _k) : k(_k) {}
+
+    // Called at every maximal clique
+    void offer(UnrolledList& R);
+    // The K largest cliques of all workers, largest first
+    vector<vector<int>> getCliques();
+    // complete: false if the search was cut (--time-limit), larger cliques may then be missing
+    void writeData(ostream& out, bool complete = true);
+private:
+    struct SmallerFirst {
+        bool operator()(const vector<int>& a, const vector<int>& b) { return a.size() > b.size(); }
+    };
+    typedef priority_queue<vector<int>, vector<vector<int>>, SmallerFirst> CliqueHeap;
+
+    int k;
+    tbb::combinable<CliqueHeap> pt_heaps;
+};
+
+#endif//_TOP_K_CLIQUES_H_
@@ -75,7 +75,7 @@ private:
     Bucket *iter;
     int iter_offs;
     /*********** private methods  *************/
-    std::pair<Bucket*, Bucket*> copy_list(MemChunk *chunk = NULL);
+    std::pair<Bucket*, Bucket*> copy_list(MemChunk *chunk = NULL, int type = MemType::OTHER);
     std::pair<Bucket*, int> find_element(KeyType el);
     void kill_list();
     static Bucket* create_bucket(MemChunk *chunk = NULL, int type = MemType::OTHER);
@@ -100,7 +100,7 @@ inline UnrolledList::UnrolledList(UnrolledList& other, int type) :
         mem_type(type != MemType::OTHER ? type : other.mem_type),
         my_chunk(other.my_chunk), isSorted(other.isSorted)
 {
-    auto new_pair = copy_list(my_chunk);
+    auto new_pair = other.copy_list(my_chunk, mem_type);
     head = new_pair.first;
     tail = new_pair.second;
     if(memLogger && !my_chunk) memLogger->addTmpMem(sizeof(UnrolledList), mem_type);
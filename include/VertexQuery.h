@@ -0,0 +1,40 @@
+#ifndef _VERTEX_QUERY_H_
+#define _VERTEX_QUERY_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include <tbb/combinable.h>
+
+#include "Graph.h"
+#include "UnrolledList.h"
+
+using namespace std;
+
+// Maximal cliques containing given vertices (--query). Every query vertex v is a root task
+// with R = {v}, P = N(v) and an empty X, on the already loaded and hashed graph.
+class VertexQueries {
+public:
+    VertexQueries(Graph* g, const vector<int>& _vertices);
+
+    // Vertex ids from a file, or from a comma separated list if there is no such file
+    static vector<int> parse(string spec);
+
+    void run(int nthr);
+    void addClique(int query, UnrolledList& R);
+    void finishQuery(int query, double runtime);
+    void writeData(ostream& out);
+
+    const vector<int>& getVertices() { return vertices; }
+    long getCliqueCount();
+private:
+    Graph* graph;
+    vector<int> vertices;
+    vector<int> positions;
+    // Flat records of every worker: query, clique size, clique vertices
+    tbb::combinable<vector<int>> pt_cliques;
+    tbb::combinable<vector<pair<int, double>>> pt_runtimes;
+};
+
+#endif//_VERTEX_QUERY_H_
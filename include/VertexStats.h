@@ -0,0 +1,67 @@
+#ifndef _VERTEX_STATS_H_
+#define _VERTEX_STATS_H_
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include <tbb/spin_mutex.h>
+
+#include "Graph.h"
+#include "UnrolledList.h"
+
+using namespace std;
+
+// Dense per-thread counters of one worker, indexed by vertex id
+struct VertexCounters {
+    VertexCounters(size_t size) : cliques(size, 0), max_size(size, 0) {}
+    vector<long> cliques;
+    vector<int> max_size;
+};
+
+// Number of maximal cliques every vertex belongs to and the size of the largest one (--vertex-stats).
+// Every leaf updates the counters of its worker; they are summed only once, when written.
+class VertexStats {
+public:
+    VertexStats(Graph* g, string _out_file_name);
+    ~VertexStats() { for(auto counters : workers) delete counters; }
+
+    void addClique(UnrolledList& R);
+    // Merges the counters of the workers with nthr threads and writes the csv
+    void writeData(int nthr);
+private:
+    VertexCounters& local_counters();
+    static long next_generation() { static std::atomic<long> gen(0); return ++gen; }
+
+    typedef tbb::spin_mutex VertexStatsMutexType;
+    VertexStatsMutexType WorkersMutex;
+    vector<VertexCounters*> workers;
+
+    Graph* graph;
+    size_t id_range; // largest vertex id + 1
+    string out_file_name;
+    const long generation; // distinguishes the thread local counters of consecutive instances
+};
+
+inline VertexCounters& VertexStats::local_counters() {
+    static thread_local VertexCounters* tl_counters = NULL;
+    static thread_local long tl_generation = 0;
+    if(tl_generation != generation) {
+        tl_counters = new VertexCounters(id_range);
+        VertexStatsMutexType::scoped_lock lock(WorkersMutex);
+        workers.push_back(tl_counters);
+        tl_generation = generation;
+    }
+    return *tl_counters;
+}
+
+inline void VertexStats::addClique(UnrolledList& R) {
+    VertexCounters& local = local_counters();
+    int size = R.size();
+    R.for_each([&](int v) {
+        local.cliques[v]++;
+        if(size > local.max_size[v]) local.max_size[v] = size;
+    });
+}
+
+#endif//_VERTEX_STATS_H_
@@ -68,7 +68,18 @@ inline void printHelp()
     std::cout << "    -b                Memory block size in bytes used for memory allocation grouping, default 20 MB" << std::endl;
     std::cout << "    --thresh          Threshold tt for P+X for task grouping, default 30" << std::endl;
     std::cout << "    --mem-thresh      Threshold tm for P+X for memory allocation grouping, default 20" << std::endl;
+    std::cout << "    --idle-split      Hands the rest of a sequential subtree back as a task when workers are idle, no argument" << std::endl;
     std::cout << "    --max-clq         Size of the maximum clique to be explored" << std::endl;
+    std::cout << "    --min-clq         Enumerates only the maximal cliques of at least this size" << std::endl;
+    std::cout << "    --max-clique      Finds one maximum clique instead of enumerating all maximal cliques, no argument" << std::endl;
+    std::cout << "    --color-bound     Additionally prunes --max-clique with a greedy colouring of P, no argument" << std::endl;
+    std::cout << "    --top-k           Finds the K largest maximal cliques instead of enumerating all of them" << std::endl;
+    std::cout << "    --top-k-out       Path to the output file of --top-k, printed by default" << std::endl;
+    std::cout << "    --kclique         Counts all cliques of the given size instead of the maximal cliques" << std::endl;
+    std::cout << "    --kclique-out     Path to the output file listing the cliques of --kclique" << std::endl;
+    std::cout << "    --query           Enumerates only the maximal cliques containing the given vertices," << std::endl;
+    std::cout << "                      a file with vertex ids or a comma separated list" << std::endl;
+    std::cout << "    --query-out       Path to the output file of --query, printed by default" << std::endl;
     std::cout << "    -s,               Defines subgraph based approach for BK algorithm," << std::endl;
     std::cout << "                          0 - don't create subgraphs" << std::endl;
     std::cout << "                          1 - create subgraphs in the outer level of the algorithm" << std::endl;
@@ -77,8 +88,47 @@ inline void printHelp()
     std::cout << "                          0 - degeneracy ordering" << std::endl;
     std::cout << "                          1 - degree ordering" << std::endl;
     std::cout << "                          2 - inverse degree ordering" << std::endl;
+    std::cout << "    --root-cost       Spawns the root tasks in the order of their estimated cost, default 0" << std::endl;
+    std::cout << "                          0 - no estimate, roots are spawned in the vertex ordering" << std::endl;
+    std::cout << "                          1 - |P| of the root" << std::endl;
+    std::cout << "                          2 - |P|*(|X|+1) of the root" << std::endl;
+    std::cout << "                          3 - |P| plus the sampled number of edges inside P" << std::endl;
+    std::cout << "    --eager-roots     Number of the heaviest roots whose first level is split into tasks, default -n" << std::endl;
+    std::cout << "    --edge-roots      Starts the enumeration from oriented edges instead of vertices, no argument" << std::endl;
+    std::cout << "    --root-stats      Prints the distribution of the initial P and X sizes of the root tasks, no argument" << std::endl;
+    std::cout << "    --root-log        Path to the output csv file with the cost estimate and the runtime of each root" << std::endl;
+    std::cout << "    --autotune        Picks -s, --thresh, -o, --mem-thresh and -b from trial runs on sampled roots," << std::endl;
+    std::cout << "                      optional argument is the number of sampled roots, default 64" << std::endl;
+    std::cout << "    --autotune-cache  Reads the autotuned settings from <graph_path>.autotune, or writes them there, no argument" << std::endl;
+    std::cout << "    --trace           Path to the output json file with the task timeline of every worker (chrome://tracing, Perfetto)" << std::endl;
+    std::cout << "    --trace-buffer    Number of the most recent events kept per worker by --trace, default 65536" << std::endl;
+    std::cout << "    --perf            Prints hardware counters of the load, ordering, hashing and enumeration phases, no argument" << std::endl;
+    std::cout << "    --report          Path to the output json file with the configuration, timings and statistics of the run" << std::endl;
+    std::cout << "    --bench           Runs a grid of configurations on the loaded graph instead of a single run," << std::endl;
+    std::cout << "                      e.g. \"n=1,2,4,8;s=0,1,2;thresh=10,30;o=0,1;mem-thresh=20;b=20480;ord=0,1\"" << std::endl;
+    std::cout << "    --bench-reps      Number of timed repetitions of every configuration, default 3" << std::endl;
+    std::cout << "    --bench-out       Path to the output csv (or .json) file of --bench, default bench.csv" << std::endl;
+    std::cout << "    --time-limit      Seconds after which no new roots or branches are started, the partial result is reported" << std::endl;
+    std::cout << "    --time-limit-out  Path to the output file with the root vertices finished before the --time-limit deadline" << std::endl;
+    std::cout << "    --progress        Prints the finished roots, cliques/s and the estimated remaining time periodically," << std::endl;
+    std::cout << "                      optional argument is the interval in seconds, default 10" << std::endl;
+    std::cout << "    --checkpoint      Path to a checkpoint with the finished roots and their clique histogram, written periodically" << std::endl;
+    std::cout << "    --checkpoint-int  Seconds between two checkpoints, default 60" << std::endl;
+    std::cout << "    --resume          Skips the roots finished in the --checkpoint of an earlier run, no argument" << std::endl;
+    std::cout << "    --shard           Enumerates only the roots of shard i of N, given as i/N, and writes a partial result file" << std::endl;
+    std::cout << "    --shard-out       Path to the partial result file of --shard, default shard_<i>_<N>.txt" << std::endl;
+    std::cout << "    --merge           Comma separated partial result files of all shards, prints their combined histogram" << std::endl;
+    std::cout << "    --merge-partial   With --merge, prints the histogram even if the result of a shard is missing" << std::endl;
+    std::cout << "    --snapshot-out    Path to a binary snapshot of the loaded and ordered graph" << std::endl;
+    std::cout << "    --snapshot        Loads the graph from a snapshot written by --snapshot-out instead of -f" << std::endl;
+    std::cout << "    --batch           Enumerates many graphs in one process, from a manifest of graph paths or one file" << std::endl;
+    std::cout << "                      in which every graph starts with a \"% graph <name>\" line; -f is not needed" << std::endl;
+    std::cout << "    --batch-out       Path to the output file with the clique histograms of --batch, printed by default" << std::endl;
+    std::cout << "    --batch-large     Graphs of --batch with at least this many edges run on the parallel task tree, default 100000" << std::endl;
+    std::cout << "    --serve           Keeps the graph loaded and answers requests on the given Unix socket, see mce_client" << std::endl;
+    std::cout << "    --vertex-stats    Path to the output csv file with the number of maximal cliques of every vertex and the largest one" << std::endl;
     std::cout << "    -m                Turns memory profiling on and defines path to the output csv file" << std::endl;
-    std::cout << "    -i                Defines sampling interval for memory profiling, default 10000" << std::endl;
+    std::cout << "    -i                Defines sampling interval for memory profiling in milliseconds, default 10" << std::endl;
     std::cout << "    -h, --help        Shows this message" << std::endl;
 }
 
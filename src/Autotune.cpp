@@ -0,0 +1,261 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <tbb/tick_count.h>
+#include <tbb/combinable.h>
+
+#include "Autotune.h"
+#include "BKTask.h"
+#include "MemUsageLogger.h"
+#include "RootLog.h"
+#include "TaskTrace.h"
+
+using namespace std;
+
+extern tbb::combinable<Histogram> pt_hist;
+extern bool CollectMemUsage;
+extern MemUsageLogger *memLogger;
+extern RootLog *rootLog;
+extern RootSizeStats *rootStats;
+extern TaskTracer *taskTracer;
+extern bool noEndPrint;
+extern int subgraphBased;
+extern bool setsMempool;
+extern int PX_threshold;
+extern int mem_threshold;
+extern unsigned int memBlockSize;
+
+// A setting is only replaced if the candidate is at least this much faster
+const double MIN_IMPROVEMENT = 0.05;
+const int TRIAL_REPETITIONS = 2;
+// The sampled roots take at most this share of the estimated cost of all the roots
+const double SAMPLE_COST_FRACTION = 0.02;
+// Time limit of the first trial, a longer one is repeated on a smaller sample. No later trial runs
+// longer, so the 14 candidates take at most about 14 * TRIAL_REPETITIONS * FIRST_TRIAL_LIMIT seconds.
+const double FIRST_TRIAL_LIMIT = 0.25;
+
+TunedSettings Autotuner::current() {
+    TunedSettings s = {subgraphBased, PX_threshold, setsMempool, mem_threshold, memBlockSize};
+    return s;
+}
+
+void Autotuner::set(const TunedSettings& s) {
+    subgraphBased = s.subgraphBased;
+    PX_threshold = s.PX_threshold;
+    setsMempool = s.setsMempool;
+    mem_threshold = s.mem_threshold;
+    memBlockSize = s.memBlockSize;
+}
+
+void Autotuner::collectStatistics() {
+    int n = graph->getNodeNo();
+    vector<int> degrees(n);
+    vector<pair<long, int>> rootCost(n); // (cost estimate, position)
+    long sum_deg = 0;
+    totalCost = 0;
+    for(int i = 0; i < n; i++) {
+        int vertex = graph->getMappedNode(i);
+        degrees[i] = graph->getAdjacentNodes(vertex)->size();
+        sum_deg += degrees[i];
+        rootCost[i] = make_pair(RootIterBKTask::root_set_cost(graph, vertex), i);
+        totalCost += rootCost[i].first;
+    }
+    sort(degrees.begin(), degrees.end());
+    auto percentile = [&](double p) { return n ? (double) degrees[min(n-1, (int)(p * n))] : 0.0; };
+    stats.nodes = n; stats.edges = sum_deg / 2;
+    stats.maxdeg = graph->maxdeg; stats.degeneracy = graph->degeneracy;
+    stats.mean_deg = n ? (double) sum_deg / n : 0;
+    stats.deg_p50 = percentile(0.5); stats.deg_p90 = percentile(0.9); stats.deg_p99 = percentile(0.99);
+
+    // Sample the heaviest roots, which dominate the runtime, and the same number of random ones. Every
+    // trial enumerates the sample, so it only gets a small share of the estimated cost of the full run:
+    // roots that do not fit in the remaining share are left out.
+    sort(rootCost.begin(), rootCost.end(), [](const pair<long, int>& a, const pair<long, int>& b) { return a.first > b.first; });
+    long budget = max(1L, (long) (SAMPLE_COST_FRACTION * totalCost));
+    vector<bool> taken(n, false);
+    sampledRoots.clear();
+    sampledCost = 0;
+    auto take = [&](int k) {
+        if(taken[k] || sampledCost + rootCost[k].first > budget) return;
+        taken[k] = true;
+        sampledRoots.push_back(rootCost[k].second);
+        sampledCost += rootCost[k].first;
+    };
+    int heavy = sample_size / 2;
+    for(int k = 0; k < n && (int) sampledRoots.size() < heavy; k++) take(k);
+    mt19937 rng(42);
+    if(n > 0) {
+        uniform_int_distribution<int> dist(0, n - 1);
+        for(int k = 0; k < sample_size - heavy; k++) take(dist(rng));
+    }
+    sort(sampledRoots.begin(), sampledRoots.end());
+
+    long p_sum = 0, x_sum = 0;
+    stats.root_p_max = 0; stats.root_x_max = 0;
+    for(int pos : sampledRoots) {
+        int vertex = graph->getMappedNode(pos);
+        int p_size = 0, x_size = 0;
+        graph->getAdjacentNodes(vertex)->for_each([&](int v) {
+            if(is_root_candidate(graph, vertex, v)) p_size++; else x_size++;
+        });
+        p_sum += p_size; x_sum += x_size;
+        stats.root_p_max = max(stats.root_p_max, p_size);
+        stats.root_x_max = max(stats.root_x_max, x_size);
+    }
+    int samples = max(1, (int) sampledRoots.size());
+    stats.root_p_mean = (double) p_sum / samples;
+    stats.root_x_mean = (double) x_sum / samples;
+}
+
+// Runs the sample with the settings; past time_limit the enumeration is cut through TimeBudget and
+// the trial returns a time of at least time_limit
+double Autotuner::trial(const TunedSettings& s, double time_limit) {
+    set(s);
+    double best_trial = -1;
+    for(int rep = 0; rep < TRIAL_REPETITIONS; rep++) {
+        std::mutex StopMutex;
+        std::condition_variable stop_cv;
+        bool stopped = false;
+        std::thread timer([&]() {
+            std::unique_lock<std::mutex> lock(StopMutex);
+            if(!stop_cv.wait_for(lock, std::chrono::duration<double>(time_limit), [&]() { return stopped; }))
+                TimeBudget::expired = true;
+        });
+        auto tick0 = tbb::tick_count::now();
+        graph->BronKerboschDegeneracy(nthr, &sampledRoots);
+        double t = (tbb::tick_count::now() - tick0).seconds();
+        {
+            std::lock_guard<std::mutex> lock(StopMutex);
+            stopped = true;
+        }
+        stop_cv.notify_all();
+        timer.join();
+        if(TimeBudget::expired) t = max(t, time_limit);
+        TimeBudget::expired = false;
+        if(best_trial < 0 || t < best_trial) best_trial = t;
+        // The second repetition can only make a cut trial look better, not good enough
+        if(t >= time_limit) break;
+    }
+    return best_trial;
+}
+
+void Autotuner::tryCandidates(const vector<TunedSettings>& candidates) {
+    for(auto& cand : candidates) {
+        // A candidate that is not faster than the best one by the margin by then cannot replace it
+        double t = trial(cand, best_time * (1 - MIN_IMPROVEMENT));
+        if(t < best_time * (1 - MIN_IMPROVEMENT)) { best = cand; best_time = t; }
+    }
+}
+
+void Autotuner::tune() {
+    // Trial runs must not show up in the results or in the profiles of the real run
+    bool collect = CollectMemUsage;
+    MemUsageLogger* mlog = memLogger;
+    RootLog* rlog = rootLog;
+    RootSizeStats* rstats = rootStats;
+    TaskTracer* tracer = taskTracer;
+    CollectMemUsage = false; memLogger = NULL; rootLog = NULL; rootStats = NULL; taskTracer = NULL;
+    noEndPrint = true;
+    TunedSettings initial = current();
+
+    // Coordinate descent: subgraph mode, task threshold, memory pooling, block size
+    best = {0, 30, false, 20, 20480};
+    best_time = trial(best, FIRST_TRIAL_LIMIT);
+    // The cost estimate missed, keep the lighter half of the sample until a trial fits in the limit
+    while(best_time >= FIRST_TRIAL_LIMIT && sampledRoots.size() > 1) {
+        sort(sampledRoots.begin(), sampledRoots.end(), [&](int a, int b) {
+            return RootIterBKTask::root_set_cost(graph, graph->getMappedNode(a)) < RootIterBKTask::root_set_cost(graph, graph->getMappedNode(b));
+        });
+        sampledRoots.resize(sampledRoots.size() / 2);
+        sampledCost = 0;
+        for(int pos : sampledRoots) sampledCost += RootIterBKTask::root_set_cost(graph, graph->getMappedNode(pos));
+        sort(sampledRoots.begin(), sampledRoots.end());
+        best_time = trial(best, FIRST_TRIAL_LIMIT);
+    }
+
+    vector<TunedSettings> candidates;
+    for(int s : {1, 2}) { TunedSettings c = best; c.subgraphBased = s; candidates.push_back(c); }
+    tryCandidates(candidates);
+
+    candidates.clear();
+    for(int t : {10, 20, 50, 80, 120}) { TunedSettings c = best; c.PX_threshold = t; candidates.push_back(c); }
+    tryCandidates(candidates);
+
+    candidates.clear();
+    for(int t : {10, 20, 40, 80}) { TunedSettings c = best; c.setsMempool = true; c.mem_threshold = t; candidates.push_back(c); }
+    tryCandidates(candidates);
+
+    if(best.setsMempool) {
+        candidates.clear();
+        for(unsigned int b : {4096u, 65536u, 262144u}) { TunedSettings c = best; c.memBlockSize = b; candidates.push_back(c); }
+        tryCandidates(candidates);
+    }
+
+    set(initial);
+    pt_hist.clear();
+    pt_algo_stats().clear();
+    BKTask::reset_task_count();
+    noEndPrint = false;
+    CollectMemUsage = collect; memLogger = mlog; rootLog = rlog; rootStats = rstats; taskTracer = tracer;
+}
+
+bool Autotuner::loadCache(string path) {
+    ifstream cache(path);
+    if(!cache.good()) return false;
+    best = current();
+    string key;
+    bool sameGraph = false;
+    while(cache >> key) {
+        if(key == "graph") {
+            long nodes, edges;
+            uint64_t checksum;
+            cache >> nodes >> edges >> checksum;
+            sameGraph = cache && nodes == graph->getNodeNo() && edges == graph->getEdgeNo() && checksum == graph->orderingChecksum();
+        }
+        else if(key == "s") cache >> best.subgraphBased;
+        else if(key == "thresh") cache >> best.PX_threshold;
+        else if(key == "o") cache >> best.setsMempool;
+        else if(key == "mem-thresh") cache >> best.mem_threshold;
+        else if(key == "b") cache >> best.memBlockSize;
+        else { string rest; getline(cache, rest); }
+    }
+    if(!sameGraph) {
+        cout << "The autotuner cache " << path << " is of another graph or ordering, tuning again" << endl;
+        best = current();
+    }
+    return sameGraph;
+}
+
+void Autotuner::saveCache(string path) {
+    ofstream cache(path);
+    cache << "# mce autotuner settings for " << stats.nodes << " vertices, " << stats.edges << " edges\n";
+    cache << "graph " << graph->getNodeNo() << " " << graph->getEdgeNo() << " " << graph->orderingChecksum() << "\n";
+    cache << "s " << best.subgraphBased << "\n";
+    cache << "thresh " << best.PX_threshold << "\n";
+    cache << "o " << best.setsMempool << "\n";
+    cache << "mem-thresh " << best.mem_threshold << "\n";
+    cache << "b " << best.memBlockSize << "\n";
+}
+
+void Autotuner::apply() { set(best); }
+
+void Autotuner::printData() {
+    if(stats.nodes) {
+        cout << "Graph statistics: #Vertex = " << stats.nodes << "; #Edge = " << stats.edges
+             << "; max degree = " << stats.maxdeg << "; mean degree = " << stats.mean_deg
+             << "; degree p50/p90/p99 = " << stats.deg_p50 << "/" << stats.deg_p90 << "/" << stats.deg_p99
+             << "; degeneracy = " << stats.degeneracy << endl;
+        cout << "Sampled roots: " << sampledRoots.size() << " (" << (totalCost ? 100.0 * sampledCost / totalCost : 0.0)
+             << "% of the estimated cost); |P| mean/max = " << stats.root_p_mean << "/" << stats.root_p_max
+             << "; |X| mean/max = " << stats.root_x_mean << "/" << stats.root_x_max << endl;
+    }
+    cout << "Autotuned settings: -s " << best.subgraphBased << " --thresh " << best.PX_threshold;
+    if(best.setsMempool) cout << " -o --mem-thresh " << best.mem_threshold << " -b " << best.memBlockSize;
+    cout << endl;
+}
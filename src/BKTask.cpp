@@ -1,5 +1,8 @@
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/parallel_reduce.h>
+#include <algorithm>
 #include "BKTask.h"
 
 using namespace std;
@@ -8,40 +11,139 @@ using namespace tbb;
 extern int subgraphBased;
 extern bool setsMempool;
 extern bool noEndPrint;
+extern bool edgeRoots;
 
-void GraphGuard::inc_graph_ref_count() {
-    RefCountMutexType::scoped_lock lock(RefCountMutex);
-    ref_count++;
-}
-
-void GraphGuard::dec_graph_ref_count(GraphGuard*& this_guard) {
-    RefCountMutexType::scoped_lock lock(RefCountMutex);
-    ref_count--;
-    if(ref_count <= 0) {
-        if(!graph->my_chunk) delete graph;
-        else graph->~Graph();
-        graph = NULL;
-        if(!my_chunk) delete this;
-        else my_chunk->decrement_allocations();
-        this_guard = NULL;
-    }
-}
+tbb::atomic<long> WorkDemand::pending_roots = 0;
+tbb::atomic<long> WorkDemand::pending_splits = 0;
+tbb::atomic<int> SearchBound::required = 0;
+tbb::atomic<bool> TimeBudget::expired = false;
 
 tbb::task* RootIterBKTask::execute() {
     tbb::task *next = NULL;
-    if(!isContinuation) next = SpawnTask(); else cout << "Number of tasks: " << taskIdCnt << "\n";
+    if(!isContinuation) {
+        tbb::tick_count t0;
+        if(taskTracer) t0 = taskTracer->now();
+        next = SpawnTask();
+        if(taskTracer) taskTracer->record(TRACE_SPAWN_ROOTS, t0);
+    }
+    else if(!noEndPrint) cout << "Number of tasks: " << get_task_count() << "\n";
     return next;
 }
 
+long RootIterBKTask::estimate_root_cost(Graph* graph, int vertex) {
+    SET_IMPL* Q = graph->getAdjacentNodes(vertex);
+    long p_size = 0, x_size = 0;
+    Q->for_each([&](int v) { if(in_root_P(graph, vertex, v)) p_size++; else x_size++; });
+    if(root_cost_mode == 1) return p_size;
+    if(root_cost_mode == 2) return p_size * (x_size + 1);
+
+    // Sampled density of P: the number of edges inside P estimated from a few of its vertices
+    const int max_samples = 16;
+    if(p_size < 2) return p_size;
+    SET_IMPL* P = SET_IMPL::create_set(NULL, MemType::ROOT_SET);
+    Q->for_each([&](int v) { if(in_root_P(graph, vertex, v)) P->add_elem(v); });
+    long samples = 0, inner_degrees = 0;
+    long step = max(1L, p_size / max_samples);
+    long idx = 0;
+    P->for_each([&](int v) {
+        if(idx++ % step != 0 || samples == max_samples) return;
+        inner_degrees += P->intersection_size(graph->getAdjacentNodes(v));
+        samples++;
+    });
+    delete P;
+    return p_size + inner_degrees * p_size / samples;
+}
+
+long RootIterBKTask::root_set_cost(Graph* graph, int vertex) {
+    long p_size = 0, x_size = 0;
+    graph->getAdjacentNodes(vertex)->for_each([&](int v) { if(in_root_P(graph, vertex, v)) p_size++; else x_size++; });
+    return p_size * (x_size + 1);
+}
+
+// Roots whose P is too small for the required clique size are not spawned at all
+bool RootIterBKTask::prunes_vertex_roots(Graph* graph, int vertex) {
+    if(requiredSize <= 1) return false;
+    SET_IMPL* Q = graph->getAdjacentNodes(vertex);
+    if(1 + Q->size() < requiredSize) return true;
+    int p_size = 0;
+    Q->for_each([&](int v) { if(in_root_P(graph, vertex, v)) p_size++; });
+    return 1 + p_size < requiredSize;
+}
+
+int RootIterBKTask::count_vertex_roots(Graph* graph, int vertex) {
+    if(prunes_vertex_roots(graph, vertex)) return 0;
+    if(!edgeRoots) return 1;
+    SET_IMPL* Q = graph->getAdjacentNodes(vertex);
+    if(Q->empty()) return 1;
+    int cnt = 0;
+    Q->for_each([&](int v) { if(is_root_candidate(graph, vertex, v)) cnt++; });
+    return cnt;
+}
+
+void RootIterBKTask::spawn_vertex_roots(Graph* graph, int vertex, long cost, bool eager) {
+    if(prunes_vertex_roots(graph, vertex)) return;
+    SET_IMPL* Q = graph->getAdjacentNodes(vertex);
+    if(!edgeRoots || Q->empty()) {
+        spawn(*new(allocate_child()) MainBKTask(vertex, graphg, subgraphBased != 0, cost, eager));
+        return;
+    }
+    // One root per oriented edge (vertex, v)
+    Q->for_each([&](int v) {
+        if(is_root_candidate(graph, vertex, v))
+            spawn(*new(allocate_child()) MainBKTask(vertex, graphg, subgraphBased != 0, cost, eager, v));
+    });
+}
+
 tbb::task* RootIterBKTask::SpawnTask() {
     Graph* graph = graphg->graph;
-    this->set_ref_count(1 + graphg->graph->getNodeNo());
+    // Positions of the root vertices in the vertex ordering
+    vector<int> roots;
+    if(selectedRoots) roots = *selectedRoots;
+    else {
+        roots.resize(graph->getNodeNo());
+        for(int i = 0; i < graph->getNodeNo(); i++) roots[i] = i;
+    }
+    // Roots finished before the run was resumed
+    if(checkpoint) roots.erase(remove_if(roots.begin(), roots.end(), [&](int pos) { return checkpoint->isResumed(pos); }), roots.end());
+    int rootVertexNo = roots.size();
+    requiredSize = SearchBound::required;
+    long rootNo = parallel_reduce(blocked_range<int>(0, rootVertexNo), 0L, [&](const blocked_range<int>& r, long cnt) {
+        for(int k = r.begin(); k != r.end(); ++k) cnt += count_vertex_roots(graph, graph->getMappedNode(roots[k]));
+        return cnt;
+    }, std::plus<long>());
+    if(progress) progress->setRoots(this, graph, roots);
+    this->set_ref_count(1 + rootNo);
     tbb::task *nextTask = NULL;
-    parallel_for( blocked_range<int>(0, graphg->graph->getNodeNo(), 1), [&](const blocked_range<int>& r) {
-          for(int i = r.begin(); i != r.end(); ++i)
-              spawn(*new(allocate_child()) MainBKTask(graph->getMappedNode(i), graphg, subgraphBased != 0));
-    }, simple_partitioner());
+    WorkDemand::pending_roots = rootNo;
+
+    if(!root_cost_mode) {
+        parallel_for( blocked_range<int>(0, rootVertexNo, 1), [&](const blocked_range<int>& r) {
+              for(int k = r.begin(); k != r.end(); ++k)
+                  spawn_vertex_roots(graph, graph->getMappedNode(roots[k]), 0, false);
+        }, simple_partitioner());
+    }
+    else {
+        // Order the roots by their estimated cost, heaviest first
+        vector<pair<long, int>> order(rootVertexNo);
+        parallel_for( blocked_range<int>(0, rootVertexNo), [&](const blocked_range<int>& r) {
+            for(int k = r.begin(); k != r.end(); ++k)
+                order[k] = make_pair(estimate_root_cost(graph, graph->getMappedNode(roots[k])), roots[k]);
+        });
+        parallel_sort(order.begin(), order.end(), [&](const pair<long, int>& a, const pair<long, int>& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+
+        // The heaviest roots are spawned first from this thread, so they sit at the stealing end
+        // of its deque and are taken by the first idle workers while the rest is being spawned.
+        int eager = min(eager_roots, rootVertexNo);
+        for(int k = 0; k < eager; k++)
+            spawn_vertex_roots(graph, graph->getMappedNode(order[k].second), order[k].first, true);
+        parallel_for( blocked_range<int>(eager, rootVertexNo, 1), [&](const blocked_range<int>& r) {
+            for(int k = r.begin(); k != r.end(); ++k)
+                spawn_vertex_roots(graph, graph->getMappedNode(order[k].second), order[k].first, false);
+        }, simple_partitioner());
+    }
     recycle_as_safe_continuation();
     isContinuation = true;
     return nextTask;
-}
\ No newline at end of file
+}
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/tick_count.h>
+#include <tbb/combinable.h>
+
+#include "Batch.h"
+#include "BKTask.h"
+
+using namespace std;
+
+extern tbb::combinable<Histogram> pt_hist;
+extern bool noEndPrint;
+extern bool degeneracyOrd;
+extern int max_clq_size;
+extern int min_clq_size;
+
+/****************** Sequential enumeration ***********************/
+// Pivoted Bron-Kerbosch on the sets of a small graph, within the task of the graph. Applies --min-clq
+// and --max-clq the way the task tree does (SearchBound and the cut in MainBKTask::StartTask).
+static void enumerate_sequential(Graph* graph, int r_size, SET_IMPL* P, SET_IMPL* X, vector<long>& histogram) {
+    if(SearchBound::prunes(r_size, P->size())) return;
+    if(P->empty()) {
+        if(X->empty()) {
+            if(r_size >= (int) histogram.size()) histogram.resize(r_size + 1, 0);
+            histogram[r_size]++;
+        }
+        return;
+    }
+    if(max_clq_size != -1 && r_size >= max_clq_size) return;
+    int pivot = graph->getPivot(P, X);
+    SET_IMPL* cand = P->exclude(graph->getAdjacentNodes(pivot), NULL, MemType::SET);
+    cand->for_each([&](int vertex) {
+        SET_IMPL* adj = graph->getAdjacentNodes(vertex);
+        SET_IMPL* intersP = P->intersect(adj, NULL, MemType::SET);
+        SET_IMPL* intersX = X->intersect(adj, NULL, MemType::SET);
+        enumerate_sequential(graph, r_size + 1, intersP, intersX, histogram);
+        delete intersP; delete intersX;
+        P->del_elem(vertex);
+        X->add_elem(vertex);
+    });
+    delete cand;
+}
+
+/****************** Input ***********************/
+bool BatchRunner::readChunk(vector<BatchGraph>& batch) {
+    batch.clear();
+    string line;
+    if(manifest) {
+        while(batch.size() < chunk && getline(in, line)) {
+            if(line.empty() || line[0] == '#') continue;
+            BatchGraph bg;
+            bg.name = bg.path = line;
+            batch.push_back(bg);
+        }
+        return !batch.empty();
+    }
+    // Concatenated file: the lines up to the next "% graph" line belong to the current graph
+    while(batch.size() < chunk && !pending.empty()) {
+        BatchGraph bg;
+        bg.name = pending.size() > 8 ? pending.substr(8) : to_string(graphs + batch.size());
+        pending.clear();
+        while(getline(in, line)) {
+            if(line.compare(0, 7, "% graph") == 0) { pending = line; break; }
+            if(line.empty()) continue;
+            bg.text += line;
+            bg.text += '\n';
+        }
+        batch.push_back(bg);
+    }
+    return !batch.empty();
+}
+
+/****************** Enumeration ***********************/
+Graph* BatchRunner::load(const BatchGraph& bg) {
+    Graph* graph = new Graph;
+    if(bg.path.empty()) {
+        istringstream text(bg.text);
+        graph->initFromStream(text);
+    }
+    else {
+        ifstream file(bg.path);
+        graph->initFromStream(file);
+    }
+    return graph;
+}
+
+void BatchRunner::runSmall(const BatchGraph& bg, BatchResult& res) {
+    Graph* graph = load(bg);
+    res.vertices = graph->getNodeNo();
+    res.edges = graph->getEdgeNo();
+    // A large graph is loaded again when its turn on the task tree comes, so that at most one of
+    // them is in memory, however many a chunk holds
+    res.large = res.edges >= large_edges;
+    if(res.large) { delete graph; return; }
+    if(degeneracyOrd) graph->degeneracyOrdering();
+    graph->hashAdjacencyLists();
+
+    vector<long> histogram((graph->degeneracy >= 0 ? graph->degeneracy : graph->maxdeg) + 2, 0);
+    for(int pos = 0; pos < graph->getNodeNo(); pos++) {
+        int vertex = graph->getMappedNode(pos);
+        SET_IMPL* P = SET_IMPL::create_set(NULL, MemType::SET);
+        SET_IMPL* X = SET_IMPL::create_set(NULL, MemType::SET);
+        graph->getAdjacentNodes(vertex)->for_each([&](int v) {
+            if(is_root_candidate(graph, vertex, v)) P->add_elem(v); else X->add_elem(v);
+        });
+        enumerate_sequential(graph, 1, P, X, histogram);
+        delete P; delete X;
+    }
+    for(size_t size = 0; size < histogram.size(); size++) if(histogram[size]) res.histogram[size] = histogram[size];
+    delete graph;
+}
+
+void BatchRunner::write(ostream& out, const BatchGraph& bg, const BatchResult& res) {
+    long total = 0;
+    for(auto& hist : res.histogram) total += hist.second;
+    out << "% graph " << bg.name << "\n";
+    out << "# #Vertex = " << res.vertices << "; #Edge = " << res.edges << "; maximal cliques = " << total << "\n";
+    for(auto& hist : res.histogram) out << hist.first << ", " << hist.second << "\n";
+    cliques += total;
+}
+
+bool BatchRunner::run(string input, ostream& out) {
+    in.open(input);
+    if(!in.good()) { cout << "Cannot read the batch input " << input << endl; return false; }
+    // A concatenated file starts with the "% graph" line of its first graph, a manifest does not
+    string line;
+    manifest = true;
+    while(getline(in, line)) {
+        if(line.empty()) continue;
+        if(line.compare(0, 7, "% graph") == 0) { manifest = false; pending = line; }
+        else { in.clear(); in.seekg(0); }
+        break;
+    }
+
+    tbb::task_scheduler_init init(nthr);
+    noEndPrint = true;
+    if(min_clq_size > 1) SearchBound::raise(min_clq_size);
+    vector<BatchGraph> batch;
+    vector<BatchResult> results;
+    while(readChunk(batch)) {
+        results.assign(batch.size(), BatchResult());
+        // One graph per task, the small graphs are not worth splitting further
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, batch.size(), 1), [&](const tbb::blocked_range<size_t>& r) {
+            for(size_t k = r.begin(); k != r.end(); k++) runSmall(batch[k], results[k]);
+        }, tbb::simple_partitioner());
+
+        for(size_t k = 0; k < batch.size(); k++) {
+            BatchResult& res = results[k];
+            if(res.large) {
+                Graph* graph = load(batch[k]);
+                if(degeneracyOrd) graph->degeneracyOrdering();
+                graph->hashAdjacencyLists();
+                pt_hist.clear();
+                BKTask::reset_task_count();
+                graph->BronKerboschDegeneracy(nthr);
+                res.histogram = Graph::cliqueHistogram(pt_hist);
+                delete graph;
+                large++;
+            }
+            write(out, batch[k], res);
+        }
+        graphs += batch.size();
+    }
+    out.flush();
+    pt_hist.clear();
+    BKTask::reset_task_count();
+    noEndPrint = false;
+    return true;
+}
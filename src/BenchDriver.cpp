@@ -0,0 +1,194 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+#include <tbb/tick_count.h>
+#include <tbb/combinable.h>
+
+#include "BenchDriver.h"
+#include "BKTask.h"
+#include "MemUsageLogger.h"
+#include "RootLog.h"
+
+using namespace std;
+
+extern tbb::combinable<Histogram> pt_hist;
+extern bool CollectMemUsage;
+extern MemUsageLogger *memLogger;
+extern RootLog *rootLog;
+extern RootSizeStats *rootStats;
+extern TaskTracer *taskTracer;
+extern bool noEndPrint;
+extern bool degeneracyOrd;
+extern bool degreeOrd;
+
+static vector<long> parse_values(string s) {
+    vector<long> values;
+    stringstream ss(s);
+    string item;
+    while(getline(ss, item, ',')) if(!item.empty()) values.push_back(stol(item));
+    return values;
+}
+
+bool BenchDriver::parseGrid(string spec, int nthr) {
+    TunedSettings cur = Autotuner::current();
+    vector<long> threads = {nthr}, subgraphs = {cur.subgraphBased}, thresholds = {cur.PX_threshold},
+        mempool = {cur.setsMempool}, mem_thresholds = {cur.mem_threshold}, blocks = {cur.memBlockSize},
+        orderings = {degeneracyOrd ? 0 : (degreeOrd ? 1 : 2)};
+    stringstream ss(spec);
+    string param;
+    while(getline(ss, param, ';')) {
+        size_t eq = param.find('=');
+        if(eq == string::npos) continue;
+        string key = param.substr(0, eq);
+        vector<long> values = parse_values(param.substr(eq + 1));
+        if(values.empty()) continue;
+        if(key == "n") threads = values;
+        else if(key == "s") subgraphs = values;
+        else if(key == "thresh") thresholds = values;
+        else if(key == "o") mempool = values;
+        else if(key == "mem-thresh") mem_thresholds = values;
+        else if(key == "b") blocks = values;
+        else if(key == "ord") orderings = values;
+        else { cout << "Unknown benchmark grid parameter " << key << endl; return false; }
+    }
+
+    grid.clear();
+    for(long ord : orderings) for(long s : subgraphs) for(long t : thresholds) for(long o : mempool)
+    for(long mt : mem_thresholds) for(long b : blocks) for(long n : threads) {
+        BenchConfig c;
+        c.settings = {(int) s, (int) t, o != 0, (int) mt, (unsigned int) b};
+        c.ordering = ord;
+        c.threads = n;
+        grid.push_back(c);
+    }
+    return true;
+}
+
+BenchResult BenchDriver::runConfig(const BenchConfig& c) {
+    Autotuner::set(c.settings);
+    degeneracyOrd = (c.ordering == 0); degreeOrd = (c.ordering == 1);
+    BenchResult res;
+    res.config = c;
+
+    // The warm-up run tracks the memory, the timed runs do not pay for it
+    CollectMemUsage = true;
+    memLogger = new MemUsageLogger("/dev/null", sampling_int);
+    graph->BronKerboschDegeneracy(c.threads);
+    memLogger->stop();
+    res.peak_kb = memLogger->getPeakUsage() / 1024;
+    delete memLogger; memLogger = NULL;
+    CollectMemUsage = false;
+
+    for(int rep = 0; rep < reps; rep++) {
+        pt_hist.clear();
+        BKTask::reset_task_count();
+        auto tick0 = tbb::tick_count::now();
+        graph->BronKerboschDegeneracy(c.threads);
+        res.times.push_back((tbb::tick_count::now() - tick0).seconds());
+    }
+    res.tasks = BKTask::get_task_count();
+    res.cliques = 0;
+    for(auto& hist : Graph::cliqueHistogram(pt_hist)) res.cliques += hist.second;
+
+    double sum = 0, sq = 0;
+    for(double t : res.times) sum += t;
+    res.mean = sum / res.times.size();
+    for(double t : res.times) sq += (t - res.mean) * (t - res.mean);
+    res.stddev = res.times.size() > 1 ? sqrt(sq / (res.times.size() - 1)) : 0;
+    res.min = *min_element(res.times.begin(), res.times.end());
+    res.max = *max_element(res.times.begin(), res.times.end());
+    return res;
+}
+
+void BenchDriver::run() {
+    // Profiling of the individual runs is off, the driver collects its own numbers
+    bool collect = CollectMemUsage;
+    MemUsageLogger* mlog = memLogger;
+    RootLog* rlog = rootLog;
+    RootSizeStats* rstats = rootStats;
+    TaskTracer* tracer = taskTracer;
+    rootLog = NULL; rootStats = NULL; taskTracer = NULL;
+    noEndPrint = true;
+    TunedSettings initial = Autotuner::current();
+    bool initialDegeneracy = degeneracyOrd, initialDegree = degreeOrd;
+
+    if(graph->degeneracy < 0) {
+        for(auto& c : grid) if(c.ordering == 0) { graph->degeneracyOrdering(); break; }
+    }
+
+    results.clear();
+    for(unsigned int k = 0; k < grid.size(); k++) {
+        results.push_back(runConfig(grid[k]));
+        const BenchResult& r = results.back();
+        cout << "Benchmark " << k + 1 << "/" << grid.size() << ": -n " << r.config.threads << " -s " << r.config.settings.subgraphBased
+             << " --thresh " << r.config.settings.PX_threshold << (r.config.settings.setsMempool ? " -o" : "")
+             << " --mem-thresh " << r.config.settings.mem_threshold << " -b " << r.config.settings.memBlockSize
+             << " --ord " << r.config.ordering << ": " << r.mean << "s +- " << r.stddev << "s" << endl;
+    }
+
+    // Strong scaling: every configuration is compared to the same one with the fewest threads
+    for(auto& r : results) {
+        const BenchResult* base = &r;
+        for(auto& o : results) {
+            const TunedSettings &a = o.config.settings, &b = r.config.settings;
+            bool same = a.subgraphBased == b.subgraphBased && a.PX_threshold == b.PX_threshold && a.setsMempool == b.setsMempool
+                && a.mem_threshold == b.mem_threshold && a.memBlockSize == b.memBlockSize && o.config.ordering == r.config.ordering;
+            if(same && o.config.threads < base->config.threads) base = &o;
+        }
+        r.speedup = base->mean / r.mean;
+        r.base_threads = base->config.threads;
+    }
+
+    Autotuner::set(initial);
+    degeneracyOrd = initialDegeneracy; degreeOrd = initialDegree;
+    pt_hist.clear();
+    BKTask::reset_task_count();
+    noEndPrint = false;
+    CollectMemUsage = collect; memLogger = mlog; rootLog = rlog; rootStats = rstats; taskTracer = tracer;
+}
+
+void BenchDriver::writeCsv(string path) {
+    ofstream out(path);
+    out << "threads, s, thresh, o, mem_thresh, b, ord, reps, time_mean_s, time_stddev_s, time_min_s, time_max_s, "
+           "peak_kb, tasks, cliques, speedup, efficiency\n";
+    for(auto& r : results) {
+        const TunedSettings& s = r.config.settings;
+        out << r.config.threads << ", " << s.subgraphBased << ", " << s.PX_threshold << ", " << s.setsMempool << ", "
+            << s.mem_threshold << ", " << s.memBlockSize << ", " << r.config.ordering << ", " << r.times.size() << ", "
+            << r.mean << ", " << r.stddev << ", " << r.min << ", " << r.max << ", " << r.peak_kb << ", " << r.tasks << ", "
+            << r.cliques << ", " << r.speedup << ", " << r.speedup * r.base_threads / r.config.threads << "\n";
+    }
+}
+
+void BenchDriver::writeJson(string path) {
+    ofstream out(path);
+    out << "[\n";
+    for(unsigned int k = 0; k < results.size(); k++) {
+        const BenchResult& r = results[k];
+        const TunedSettings& s = r.config.settings;
+        out << "  {\"threads\": " << r.config.threads << ", \"s\": " << s.subgraphBased << ", \"thresh\": " << s.PX_threshold
+            << ", \"o\": " << (s.setsMempool ? "true" : "false") << ", \"mem_thresh\": " << s.mem_threshold << ", \"b\": " << s.memBlockSize
+            << ", \"ord\": " << r.config.ordering << ", \"times_s\": [";
+        for(unsigned int i = 0; i < r.times.size(); i++) out << (i ? ", " : "") << r.times[i];
+        out << "], \"time_mean_s\": " << r.mean << ", \"time_stddev_s\": " << r.stddev << ", \"peak_kb\": " << r.peak_kb
+            << ", \"tasks\": " << r.tasks << ", \"cliques\": " << r.cliques << ", \"speedup\": " << r.speedup
+            << ", \"efficiency\": " << r.speedup * r.base_threads / r.config.threads << "}"
+            << (k + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+void BenchDriver::printData() {
+    long cliques = results.empty() ? 0 : results[0].cliques;
+    for(auto& r : results)
+        if(r.cliques != cliques) { cout << "Warning: the number of cliques differs between the configurations" << endl; break; }
+    const BenchResult* best = NULL;
+    for(auto& r : results) if(!best || r.mean < best->mean) best = &r;
+    if(best) cout << "Fastest configuration: -n " << best->config.threads << " -s " << best->config.settings.subgraphBased
+                  << " --thresh " << best->config.settings.PX_threshold << (best->config.settings.setsMempool ? " -o" : "")
+                  << " --mem-thresh " << best->config.settings.mem_threshold << " -b " << best->config.settings.memBlockSize
+                  << " --ord " << best->config.ordering << " (" << best->mean << "s)" << endl;
+}
@@ -31,8 +31,8 @@ extern int mem_threshold;
 extern int max_clq_size;
 extern unsigned int memBlockSize;
 extern ofstream mem_log_stream;
-
-tbb::atomic<unsigned long> BKTask::taskIdCnt = 0;
+extern RootLog *rootLog;
+extern bool idleSplit;
 
 inline void store_clique(Clique& R) {
     // populate this function according to your needs if you would like the cliques found to be stored
@@ -56,26 +56,38 @@ inline void MainBKTask::create_root_sets(SET_IMPL*& P, SET_IMPL*& X) {
     P = SET_IMPL::create_set(NULL, MemType::ROOT_SET);
     X = SET_IMPL::create_set(NULL, MemType::ROOT_SET);
 
-    Q->for_each([&](int vertex_name) {
-        // Determine if the node is in P or X
-        if (degeneracyOrd) {
-            if (graph->getNodePosition(vertex_name) > graph->getNodePosition(new_vertex))
-                P->add_elem(vertex_name);
-            else
-                X->add_elem(vertex_name);
-        } else {
-            int this_vertex_size = graph->getAdjacentNodes(vertex_name)->size();
-            int other_vertex_size = graph->getAdjacentNodes(new_vertex)->size();
-            if ( (degreeOrd && (this_vertex_size > other_vertex_size) || !degreeOrd && (this_vertex_size < other_vertex_size))
-                 || (this_vertex_size == other_vertex_size && vertex_name > new_vertex))
-                P->add_elem(vertex_name);
-            else
-                X->add_elem(vertex_name);
-        }
-    });
+    if(vertexQueries) {
+        // Vertex query: all the cliques through the vertex, so no neighbour is excluded by the ordering
+        Q->for_each([&](int vertex_name) { P->add_elem(vertex_name); });
+    }
+    else if(second_vertex == -1) {
+        Q->for_each([&](int vertex_name) {
+            // Determine if the node is in P or X
+            if (is_root_candidate(graph, new_vertex, vertex_name)) P->add_elem(vertex_name);
+            else X->add_elem(vertex_name);
+        });
+    }
+    else {
+        // Edge root: common neighbours after the second vertex go to P, the others to X
+        SET_IMPL *Q2 = graph->getAdjacentNodes(second_vertex);
+        Q->for_each([&](int vertex_name) {
+            if (!Q2->contains(vertex_name)) return;
+            if (is_root_candidate(graph, second_vertex, vertex_name)) P->add_elem(vertex_name);
+            else X->add_elem(vertex_name);
+        });
+    }
 }
 /************* execute *******************/
 tbb::task* MainBKTask::execute() {
+    if(perfCounters) perfCounters->attach_thread();
+    if(taskTracer) {
+        tbb::tick_count t0 = taskTracer->now();
+        int type = parent ? TRACE_TASK : TRACE_ROOT_TASK;
+        int vertex = new_vertex, second = second_vertex;
+        tbb::task* next = !isContinuation ? SpawnTask() : Continuation();
+        taskTracer->record(type, t0, vertex, second);
+        return next;
+    }
     if (!isContinuation)
         return SpawnTask();
     else
@@ -84,11 +96,30 @@ tbb::task* MainBKTask::execute() {
 
 /************* Spawn Task *******************/
 tbb::task* MainBKTask::SpawnTask() {
+    if(isSplit) {
+        WorkDemand::pending_splits--;
+        isSplit = false;
+    }
     if(newTask) {
         if(!parent) {
+            if(idleSplit) WorkDemand::pending_roots--;
+            // Roots that have not started by the deadline are left out
+            if(TimeBudget::expired) return NULL;
             R_task = new Clique(NULL, MemType::ROOT_CLIQUE);
             R_task->push_back(new_vertex);
+            if(second_vertex != -1) R_task->push_back(second_vertex);
             create_root_sets(P_task, X_task);
+            if(rootStats) rootStats->addRoot(P_task->size(), X_task->size());
+            if(rootLog) {
+                rootPsize = P_task->size(); rootXsize = X_task->size();
+            }
+            if(rootLog || taskTracer || vertexQueries) rootStart = tbb::tick_count::now();
+            if(checkpoint || (progress && progress->hasTimeLimit())) {
+                // No clique of the subtree is larger than R + P of the root
+                rootSizesLen = R_task->size() + P_task->size() + 1;
+                rootSizes = new tbb::atomic<long>[rootSizesLen];
+                for(int size = 0; size < rootSizesLen; size++) rootSizes[size] = 0;
+            }
         }
 
         bool end = StartTask(*R_task, P_task, X_task, graphg, cand_task);
@@ -137,6 +168,30 @@ inline tbb::task* MainBKTask::Continuation() {
     }
 
     if(subgraphBased == 1 && NewGraph) graphg->dec_graph_ref_count(graphg);
+    if(leafCount) root->rootCliques += leafCount;
+    if(cliqueSizes && root->rootSizes) {
+        for(size_t size = 0; size < cliqueSizes->size(); size++)
+            if((*cliqueSizes)[size]) root->rootSizes[size] += (*cliqueSizes)[size];
+    }
+    // The children have all added their cliques to rootSizes by now
+    vector<long> subtreeSizes;
+    if(!parent && rootSizes) {
+        subtreeSizes.assign(rootSizes, rootSizes + rootSizesLen);
+        while(!subtreeSizes.empty() && !subtreeSizes.back()) subtreeSizes.pop_back();
+    }
+
+    // All the tasks of this root subtree are finished at this point
+    if(!parent && rootLog)
+        rootLog->addRoot(new_vertex, second_vertex, rootCost, rootPsize, rootXsize, (tbb::tick_count::now() - rootStart).seconds(),
+                         rootCliques);
+    if(!parent && taskTracer)
+        taskTracer->record(TRACE_ROOT_SUBTREE, rootStart, new_vertex, second_vertex);
+    if(!parent && vertexQueries)
+        vertexQueries->finishQuery(new_vertex, (tbb::tick_count::now() - rootStart).seconds());
+    if(!parent && checkpoint && !rootCut)
+        checkpoint->finishRoot(new_vertex, rootSizes ? &subtreeSizes : NULL);
+    if(!parent && progress)
+        progress->finishRoot(new_vertex, second_vertex, rootCliques, !rootCut, rootSizes ? &subtreeSizes : NULL);
 
     if(sets_chunk) delete sets_chunk;
     sets_chunk = NULL;
@@ -150,31 +205,81 @@ inline tbb::task* MainBKTask::SequentialRun(Clique& R, SET_IMPL*& P, SET_IMPL*&
     if(end) return NULL;
 
 	/// Recursing
-    #pragma forceinline recursive
-	cand->for_each([&](int current_node) {
-        tbb::task* a = LoopIteration(current_node, R, P, X, gg);
-        if(a) { increment_ref_count(); spawn(*a); }
-	});
+    if(!idleSplit) {
+        #pragma forceinline recursive
+        cand->for_each([&](int current_node) {
+            tbb::task* a = LoopIteration(current_node, R, P, X, gg);
+            if(a) { increment_ref_count(); spawn(*a); }
+        });
+    }
+    else {
+        cand->reset_iterator();
+        int remaining = cand->size();
+        while(!cand->end_iter()) {
+            int current_node = cand->get_next();
+            remaining--;
+            tbb::task* a = LoopIteration(current_node, R, P, X, gg);
+            if(a) { increment_ref_count(); spawn(*a); }
+            // Give the rest of this subtree to the idle workers, once per task
+            if(!hasSplit && remaining >= MIN_SPLIT_ITERATIONS && WorkDemand::idle_workers()) {
+                hasSplit = true;
+                SplitRemaining(R, P, X, cand, gg);
+                break;
+            }
+        }
+    }
 
-	delete_set(cand); delete_set(P); delete_set(X);
+	delete_set(cand); if(P) delete_set(P); if(X) delete_set(X);
 	if(subgraphBased == 3) gg->dec_graph_ref_count(gg);
 	return NULL;
 
 }
 
+/************* Split Remaining *******************/
+// Moves the remaining iterations over cand, together with P and X, to a new stealable task.
+// P and X are handed over and set to NULL; cand keeps only the iterations already done.
+inline void MainBKTask::SplitRemaining(Clique& R, SET_IMPL*& P, SET_IMPL*& X, SET_IMPL*& cand, GraphGuard* gg) {
+    // The sets may live in this task's memory chunk, so the new task gets its own copies
+    SET_IMPL *Pcpy = SET_IMPL::create_set(NULL, MemType::SET);
+    SET_IMPL *Xcpy = SET_IMPL::create_set(NULL, MemType::SET);
+    SET_IMPL *rest = SET_IMPL::create_set(NULL, MemType::SET);
+    P->for_each([&](int node) { Pcpy->add_elem(node); });
+    X->for_each([&](int node) { Xcpy->add_elem(node); });
+    while(!cand->end_iter()) rest->add_elem(cand->get_next());
+    delete_set(P); delete_set(X);
+
+    Clique *Rcpy = new Clique(R, MemType::CLIQUE);
+    MainBKTask *t = new(allocate_child()) MainBKTask(Rcpy, Pcpy, Xcpy, gg, /*New Graph*/ (subgraphBased > 1), /*parent*/ this);
+    if(subgraphBased > 1) gg->inc_graph_ref_count();
+    t->resume(rest);
+
+    WorkDemand::pending_splits++;
+    increment_ref_count();
+    spawn(*t);
+}
+
 /************* Start Task *******************/
 
 inline bool MainBKTask::StartTask(Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGuard*& gg, /*out*/ SET_IMPL*& cand) {
+    ALGO_STAT_INC(STAT_NODES);
+    // Subtrees that cannot reach the required clique size end like leaves, without a clique
+    bool pruned = SearchBound::prunes(R.size(), P->size()) || (!P->empty() && maxClique && maxClique->colorPrunes(gg->graph, R.size(), P));
     // Exiting recursion
-    if(P->empty()) {
-        if(X->empty()) {
-            auto& my_hist = pt_hist.local();
-            int r_size = R.size();
-
-            if(my_hist.find(r_size) == my_hist.end())
-                my_hist[r_size] = 0;
-
-            my_hist[r_size]++;
+    if(P->empty() || pruned) {
+        if(pruned) ALGO_STAT_INC(STAT_PRUNED);
+        else ALGO_STAT_INC(X->empty() ? STAT_LEAVES : STAT_DEAD_ENDS);
+        if(!pruned && X->empty() && maxClique) maxClique->offer(R);
+        else if(!pruned && X->empty() && topK) topK->offer(R);
+        else if(!pruned && X->empty()) {
+            pt_hist.local().add(R.size());
+            leafCount++;
+            if(checkpoint || (progress && progress->hasTimeLimit())) {
+                if(!cliqueSizes) cliqueSizes = new vector<long>;
+                if(R.size() >= cliqueSizes->size()) cliqueSizes->resize(R.size() + 1, 0);
+                (*cliqueSizes)[R.size()]++;
+            }
+            if(vertexStats) vertexStats->addClique(R);
+            if(vertexQueries) vertexQueries->addClique(root->new_vertex, R);
             store_clique(R);
         }
 
@@ -186,6 +291,8 @@ inline bool MainBKTask::StartTask(Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGu
     }
 
     if(max_clq_size != -1 && R.size() >= max_clq_size) return true;
+    ALGO_STAT_HIST(HIST_P_SIZE, P->size());
+    ALGO_STAT_HIST(HIST_X_SIZE, X->size());
 
     MemChunk* sets_chunk_ptr = NULL;
     if(setsMempool) sets_chunk_ptr = sets_chunk;
@@ -198,7 +305,10 @@ inline bool MainBKTask::StartTask(Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGu
     {
         int memType = !isRootSg ? MemType::SUBGRAPH : MemType::ROOT_SUBGRAPH;
 
+        tbb::tick_count t0;
+        if(taskTracer) t0 = taskTracer->now();
         Graph *Subgraph = gg->graph->createHpxSubgraph(R.back(), P, X, NULL, memType);
+        if(taskTracer) taskTracer->record(TRACE_SUBGRAPH, t0, R.back());
         thisgg = new GraphGuard(Subgraph);
 
         if(!isRootSg && subgraphBased != 1) gg->dec_graph_ref_count(gg);
@@ -224,6 +334,7 @@ inline bool MainBKTask::StartTask(Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGu
 
     if (sets_chunk_ptr) sets_chunk_ptr->increment_allocations();
     cand = P->exclude(graph->getAdjacentNodes(pivot), sets_chunk_ptr, MemType::SET);
+    ALGO_STAT_HIST(HIST_CAND_SIZE, cand->size());
 
     return false;
 }
@@ -231,6 +342,19 @@ inline bool MainBKTask::StartTask(Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGu
 /************* Loop Iteration *******************/
 
 inline tbb::task* MainBKTask::LoopIteration(int vertex, Clique& R, SET_IMPL*& P, SET_IMPL*& X, GraphGuard*& gg, bool seq) {
+    if(TimeBudget::expired) {
+        root->rootCut = true;
+        P->del_elem(vertex);
+        X->add_elem(vertex);
+        return NULL;
+    }
+    // The child's P is a subset of P, so it cannot reach the bound either
+    if(SearchBound::prunes(R.size() + 1, P->size() - 1)) {
+        ALGO_STAT_INC(STAT_PRUNED);
+        P->del_elem(vertex);
+        X->add_elem(vertex);
+        return NULL;
+    }
     Graph*& graph = gg->graph;
     MemChunk* sets_chunk_ptr = NULL;
     if(setsMempool && P->size() + X->size() < mem_threshold) {
@@ -244,22 +368,35 @@ inline tbb::task* MainBKTask::LoopIteration(int vertex, Clique& R, SET_IMPL*& P,
     /// Intersect P and X with the adjacency list
     if (sets_chunk_ptr) sets_chunk_ptr->increment_allocations();
     intersP = P->intersect(graph->getAdjacentNodes(vertex), sets_chunk_ptr, MemType::SET);
-    if (sets_chunk_ptr) sets_chunk_ptr->increment_allocations();
-    intersX = X->intersect(graph->getAdjacentNodes(vertex), sets_chunk_ptr, MemType::SET);
-
     // Move vertex from P to X
     P->del_elem(vertex);
+    if(SearchBound::prunes(R.size() + 1, intersP->size())) {
+        ALGO_STAT_INC(STAT_PRUNED);
+        delete_set(intersP);
+        X->add_elem(vertex);
+        return NULL;
+    }
+    if (sets_chunk_ptr) sets_chunk_ptr->increment_allocations();
+    intersX = X->intersect(graph->getAdjacentNodes(vertex), sets_chunk_ptr, MemType::SET);
     X->add_elem(vertex);
 
     tbb::task *a = NULL;
-    if(intersP->size() + intersX->size() < PX_threshold)
+    // Eagerly split roots expand their first level as separate tasks regardless of the threshold
+    bool eager = eagerSplit && taskLevel == 0;
+    if(intersP->size() + intersX->size() < PX_threshold && !eager)
     {
         taskSpawnCnt++;
         taskLevel++;
         R.push_back(vertex);
 
         if(subgraphBased == 3) gg->inc_graph_ref_count();
-        a = SequentialRun(R, intersP, intersX, gg);
+        if(taskTracer && taskLevel == 1) {
+            // Only the outermost sequential call is traced, the nested ones are part of it
+            tbb::tick_count t0 = taskTracer->now();
+            a = SequentialRun(R, intersP, intersX, gg);
+            taskTracer->record(TRACE_SEQUENTIAL, t0, vertex);
+        }
+        else a = SequentialRun(R, intersP, intersX, gg);
 
         R.pop_back();
         taskLevel--;
@@ -278,10 +415,14 @@ inline tbb::task* MainBKTask::LoopIteration(int vertex, Clique& R, SET_IMPL*& P,
 /********************************************************************************/
 /**************** Top level function for parallel BK ****************************/
 /********************************************************************************/
-void Graph::BronKerboschDegeneracy(int nthr) {
+void Graph::BronKerboschDegeneracy(int nthr, const vector<int>* roots) {
     tbb::task_scheduler_init init(nthr);
+    // A clique has at most degeneracy+1 vertices, so the per-thread histograms never grow
+    Histogram::expected_size = (degeneracy >= 0 ? degeneracy : maxdeg) + 2;
+    Histogram::start = tbb::tick_count::now();
+    WorkDemand::pending_splits = 0;
     GraphGuard *gg = new GraphGuard(this);
-    BKTask &rt = *new(tbb::task::allocate_root()) RootIterBKTask(gg);
+    BKTask &rt = *new(tbb::task::allocate_root()) RootIterBKTask(gg, roots);
     tbb::task::spawn_root_and_wait(rt);
     delete gg;
 }
\ No newline at end of file
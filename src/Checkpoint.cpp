@@ -0,0 +1,133 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+#include "Checkpoint.h"
+
+using namespace std;
+
+extern bool degeneracyOrd;
+extern bool degreeOrd;
+extern int max_clq_size;
+extern int min_clq_size;
+
+Checkpoint::Checkpoint(Graph* g, string _path, double _interval, const vector<int>* roots) : graph(g), path(_path), interval(_interval),
+    done((g->getNodeNo() + 63) / 64, 0), finished(0), resumedRoots(0), stopped(false) {
+    checksum = runChecksum(g, roots);
+}
+
+uint64_t Checkpoint::runChecksum(Graph* g) {
+    uint64_t h = g->orderingChecksum();
+    auto mix = [&](uint64_t x) { h = (h ^ x) * 1099511628211ULL; };
+    mix(degeneracyOrd); mix(degreeOrd); mix(max_clq_size + 1); mix(min_clq_size + 1);
+    return h;
+}
+
+uint64_t Checkpoint::runChecksum(Graph* g, const vector<int>* roots) {
+    uint64_t h = runChecksum(g);
+    if(!roots) return h;
+    auto mix = [&](uint64_t x) { h = (h ^ x) * 1099511628211ULL; };
+    mix(roots->size());
+    for(int position : *roots) mix(position + 1);
+    return h;
+}
+
+/****************** Resume ***********************/
+bool Checkpoint::load() {
+    ifstream in(path);
+    if(!in.good()) { cout << "No checkpoint found at " << path << ", starting from the beginning" << endl; return false; }
+    string magic, key;
+    long nodes, edges, roots, sizes, words;
+    uint64_t sum;
+    in >> magic >> key >> nodes >> edges >> sum;
+    if(!in || magic != "mce-checkpoint" || nodes != graph->getNodeNo() || edges != graph->getEdgeNo() || sum != checksum) {
+        cout << "The checkpoint " << path << " is of another graph or other settings, starting from the beginning" << endl;
+        return false;
+    }
+    in >> key >> roots >> key >> sizes;
+    vector<long> hist(sizes);
+    for(long k = 0; k < sizes; k++) in >> hist[k];
+    in >> key >> words;
+    vector<uint64_t> bits(words);
+    for(long k = 0; k < words; k++) in >> hex >> bits[k];
+    if(!in || words != (long) done.size()) { cout << "The checkpoint " << path << " is truncated, starting from the beginning" << endl; return false; }
+
+    resumed.assign(graph->getNodeNo(), false);
+    for(int pos = 0; pos < graph->getNodeNo(); pos++) resumed[pos] = (bits[pos / 64] >> (pos % 64)) & 1;
+    resumedHistogram = hist;
+    resumedRoots = roots;
+    // The next checkpoints also hold the roots of the resumed run
+    done = bits;
+    histogram = hist;
+    finished = roots;
+    return true;
+}
+
+void Checkpoint::addResumed(tbb::combinable<Histogram>& pt_hist) {
+    Histogram& local = pt_hist.local();
+    for(size_t size = 0; size < resumedHistogram.size(); size++) {
+        if(!resumedHistogram[size]) continue;
+        if(size >= local.counts.size()) local.resize(size + 1);
+        if(!local.counts[size]) local.first_found[size] = Histogram::start;
+        local.counts[size] += resumedHistogram[size];
+    }
+}
+
+/****************** Checkpoints ***********************/
+void Checkpoint::finishRoot(int vertex, const vector<long>* hist) {
+    int position = graph->getNodePosition(vertex);
+    tbb::spin_mutex::scoped_lock lock(StateMutex);
+    done[position / 64] |= 1ULL << (position % 64);
+    finished++;
+    if(!hist) return;
+    if(hist->size() > histogram.size()) histogram.resize(hist->size(), 0);
+    for(size_t size = 0; size < hist->size(); size++) histogram[size] += (*hist)[size];
+}
+
+void Checkpoint::flush() {
+    vector<uint64_t> bits;
+    vector<long> hist;
+    long roots;
+    {
+        tbb::spin_mutex::scoped_lock lock(StateMutex);
+        bits = done; hist = histogram; roots = finished;
+    }
+    // Written next to the previous checkpoint and renamed, so a preemption never leaves half a file
+    string tmp = path + ".tmp";
+    {
+        ofstream out(tmp);
+        out << "mce-checkpoint graph " << graph->getNodeNo() << " " << graph->getEdgeNo() << " " << checksum << "\n";
+        out << "roots " << roots << "\n";
+        out << "histogram " << hist.size();
+        for(long c : hist) out << " " << c;
+        out << "\nbitmap " << bits.size() << "\n" << hex;
+        for(size_t k = 0; k < bits.size(); k++) out << bits[k] << ((k % 8 == 7) ? "\n" : " ");
+        out << "\n";
+        if(!out.good()) { cout << "Cannot write the checkpoint " << tmp << endl; return; }
+    }
+    rename(tmp.c_str(), path.c_str());
+}
+
+void Checkpoint::flushing_loop() {
+    std::unique_lock<std::mutex> lock(StopMutex);
+    while(!stopped) {
+        stop_cv.wait_for(lock, std::chrono::duration<double>(interval));
+        if(stopped) break;
+        flush();
+    }
+}
+
+void Checkpoint::start() {
+    if(interval > 0) flusher = std::thread([this]() { flushing_loop(); });
+}
+
+void Checkpoint::stop() {
+    {
+        std::lock_guard<std::mutex> lock(StopMutex);
+        if(stopped) return;
+        stopped = true;
+    }
+    stop_cv.notify_all();
+    if(flusher.joinable()) flusher.join();
+    flush();
+}
@@ -18,6 +18,7 @@ extern bool CollectMemUsage;
 Graph* Graph::createHpxSubgraph(int current_node, SET_IMPL*& P, SET_IMPL*& X, MemChunk *chunk, int mem_type) {
 	int numberOfElems = P->size() + X->size();
 	Graph *Subgraph = NULL;
+	ALGO_STAT_INC(STAT_SUBGRAPHS);
 	if(!chunk) Subgraph = new Graph(numberOfElems, NULL, mem_type);
 	else Subgraph = new( chunk->get_address(sizeof(Graph)) ) Graph(numberOfElems, chunk, mem_type);
 
@@ -117,8 +118,52 @@ int Graph::degeneracyOrdering() {
 	return degen;
 }
 
+long Graph::pruneToCore(int k) {
+	// Peel by degree counts only, the adjacency lists are rebuilt once at the end
+	vector<int> degree(nodeNo);
+	vector<bool> removed(nodeNo, false);
+	vector<int> queue;
+	for(int pos = 0; pos < nodeNo; pos++) {
+		degree[pos] = adjList[vertexOrdering[pos]]->size();
+		if(degree[pos] < k) { removed[pos] = true; queue.push_back(pos); }
+	}
+	for(size_t head = 0; head < queue.size(); head++) {
+		adjList[vertexOrdering[queue[head]]]->for_each([&](int n) {
+			int pos = backwardsMapping[n];
+			if(!removed[pos] && --degree[pos] < k) { removed[pos] = true; queue.push_back(pos); }
+		});
+	}
+	if(queue.empty()) return 0;
+
+	vector<int> remaining;
+	edgeNo = 0; maxdeg = 0;
+	for(int pos = 0; pos < nodeNo; pos++) {
+		int node = vertexOrdering[pos];
+		SET_IMPL* list = adjList[node];
+		if(removed[pos]) { delete list; adjList.erase(node); continue; }
+		SET_IMPL* pruned = SET_IMPL::create_set(NULL, mem_type);
+		list->for_each([&](int n) { if(!removed[backwardsMapping[n]]) pruned->add_elem(n); });
+		delete list;
+		adjList[node] = pruned;
+		edgeNo += pruned->size();
+		maxdeg = max(maxdeg, pruned->size());
+		remaining.push_back(node);
+	}
+	nodeNo = remaining.size();
+	vertexOrdering = remaining;
+	backwardsMapping.clear();
+	for(int pos = 0; pos < nodeNo; pos++) backwardsMapping[vertexOrdering[pos]] = pos;
+	return queue.size();
+}
+
 void Graph::initFromFile(string path) {
 	ifstream graphFile(path);
+	initFromStream(graphFile);
+	cout << "#Vertex = " << nodeNo << "; #Edge = " << edgeNo/2 << endl;
+	graphFile.close();
+}
+
+void Graph::initFromStream(istream& graphFile) {
     nodeNo = -1;
     bool firstRow = true;
 	while(true) {
@@ -149,29 +194,113 @@ void Graph::initFromFile(string path) {
         backwardsMapping[pair.first] = it;
         it++;
     }
+}
+
+static const char SNAPSHOT_MAGIC[8] = {'M', 'C', 'E', 'S', 'N', 'A', 'P', '1'};
+
+bool Graph::writeSnapshot(string path) {
+	ofstream out(path, ios::binary);
+	int64_t header[2] = {nodeNo, edgeNo};
+	int32_t degrees[2] = {maxdeg, degeneracy};
+	out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	out.write((const char*) header, sizeof(header));
+	out.write((const char*) degrees, sizeof(degrees));
+	vector<int32_t> record;
+	for(int pos = 0; pos < nodeNo; pos++) {
+		int node = vertexOrdering[pos];
+		SET_IMPL* list = adjList[node];
+		record.assign(1, node);
+		record.push_back(list->size());
+		list->for_each([&](int n) { record.push_back(n); });
+		out.write((const char*) record.data(), record.size() * sizeof(int32_t));
+	}
+	return out.good();
+}
+
+bool Graph::readSnapshot(string path) {
+	ifstream in(path, ios::binary);
+	char magic[8];
+	int64_t header[2];
+	int32_t degrees[2];
+	in.read(magic, sizeof(magic));
+	in.read((char*) header, sizeof(header));
+	in.read((char*) degrees, sizeof(degrees));
+	if(!in || !equal(magic, magic + 8, SNAPSHOT_MAGIC)) return false;
+	nodeNo = header[0];
+	adjList.reserve(nodeNo);
+	vertexOrdering.resize(nodeNo);
+	backwardsMapping.reserve(nodeNo);
+	vector<int32_t> neighbours;
+	for(int pos = 0; pos < nodeNo; pos++) {
+		int32_t node, degree;
+		in.read((char*) &node, sizeof(node));
+		in.read((char*) &degree, sizeof(degree));
+		neighbours.resize(degree);
+		in.read((char*) neighbours.data(), degree * sizeof(int32_t));
+		if(!in) return false;
+		SET_IMPL* list = SET_IMPL::create_set(NULL, mem_type);
+		for(int32_t n : neighbours) list->add_elem(n);
+		adjList[node] = list;
+		vertexOrdering[pos] = node;
+		backwardsMapping[node] = pos;
+	}
+	edgeNo = header[1];
+	maxdeg = degrees[0];
+	degeneracy = degrees[1];
+	cout << "#Vertex = " << nodeNo << "; #Edge = " << edgeNo/2 << endl;
+	return true;
+}
+
+uint64_t Graph::orderingChecksum() {
+	uint64_t h = 14695981039346656037ULL;
+	for(int pos = 0; pos < nodeNo; pos++) h = (h ^ (uint32_t) vertexOrdering[pos]) * 1099511628211ULL;
+	return h;
+}
+
+void Graph::hashAdjacencyLists() {
 #ifdef HASH_JOIN_SET_IMPL
-    // Hash the adjacency lists
     for (const auto &pair : adjList) {
             SET_IMPL *const &list = pair.second;
             if(list) list->hashSet();
         }
 #endif
-	cout << "#Vertex = " << nodeNo << "; #Edge = " << edgeNo/2 << endl;
-	graphFile.close();
 }
 
-void Graph::writeCliqueHist(tbb::combinable<Histogram>& pt_hist) {
-	map<int,int> histogram;
-    long maxClqNum = 0;
-	pt_hist.combine_each([&](Histogram hist) {
-        for(auto& pair : hist) {
-            const int& clq_size = pair.first;
-            const long& clq_num = pair.second;
-            maxClqNum += clq_num;
-            if(histogram.find(clq_size) == histogram.end()) histogram[clq_size] = 0;
-            histogram[clq_size] += clq_num;
+int Histogram::expected_size = 0;
+tbb::tick_count Histogram::start;
+
+void Histogram::resize(size_t size) {
+	const size_t line = L2_CACHE_LINE / sizeof(long);
+	size = (max(size, (size_t) expected_size) + line - 1) / line * line;
+	counts.resize(size, 0);
+	first_found.resize(size);
+}
+
+map<int, long> Graph::cliqueHistogram(tbb::combinable<Histogram>& pt_hist) {
+	map<int, long> histogram;
+	pt_hist.combine_each([&](const Histogram& hist) {
+        for(size_t clq_size = 0; clq_size < hist.counts.size(); clq_size++)
+            if(hist.counts[clq_size]) histogram[clq_size] += hist.counts[clq_size];
+	});
+	return histogram;
+}
+
+map<int, double> Graph::cliqueFirstFound(tbb::combinable<Histogram>& pt_hist) {
+	map<int, double> first_found;
+	pt_hist.combine_each([&](const Histogram& hist) {
+        for(size_t clq_size = 0; clq_size < hist.counts.size(); clq_size++) {
+            if(!hist.counts[clq_size]) continue;
+            double t = (hist.first_found[clq_size] - Histogram::start).seconds();
+            if(first_found.find(clq_size) == first_found.end() || t < first_found[clq_size]) first_found[clq_size] = t;
         }
 	});
+	return first_found;
+}
+
+void Graph::writeCliqueHist(tbb::combinable<Histogram>& pt_hist) {
+	map<int, long> histogram = cliqueHistogram(pt_hist);
+    long maxClqNum = 0;
+	for(auto hist : histogram) maxClqNum += hist.second;
 	cout << "# Number of maximal cliques: " << maxClqNum << "\n";
 	cout << "# Clique histogram:\n";
 	cout << "# clique_size, num_of_cliques\n";
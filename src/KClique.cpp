@@ -0,0 +1,152 @@
+#include <iostream>
+#include <vector>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include "KClique.h"
+
+using namespace std;
+
+extern int PX_threshold;
+
+const size_t LIST_BUFFER_SIZE = 1 << 20;
+
+KCliques::KCliques(Graph* g, int _k, int nthr, string list_path) : graph(g), k(_k), listing(!list_path.empty()) {
+    if(listing) list_stream.open(list_path);
+    tbb::task_scheduler_init init(nthr);
+    // Successor lists are built in parallel and inserted into the oriented graph afterwards
+    int n = graph->getNodeNo();
+    vector<SET_IMPL*> successors(n);
+    tbb::parallel_for(tbb::blocked_range<int>(0, n), [&](const tbb::blocked_range<int>& r) {
+        for(int pos = r.begin(); pos != r.end(); ++pos) {
+            int vertex = graph->getMappedNode(pos);
+            SET_IMPL* list = SET_IMPL::create_set(NULL, MemType::GRAPH);
+            graph->getAdjacentNodes(vertex)->for_each([&](int v) { if(is_root_candidate(graph, vertex, v)) list->add_elem(v); });
+            successors[pos] = list;
+        }
+    });
+    oriented = new Graph(n);
+    for(int pos = 0; pos < n; pos++) oriented->setAdjacentNodes(graph->getMappedNode(pos), successors[pos]);
+    tbb::parallel_for(0, n, [&](int pos) { successors[pos]->hashSet(); });
+}
+
+KCliques::~KCliques() {
+    delete oriented;
+}
+
+SET_IMPL* KCliques::rootSet(int vertex) {
+    SET_IMPL* P = SET_IMPL::create_set(NULL, MemType::ROOT_SET);
+    oriented->getAdjacentNodes(vertex)->for_each([&](int v) { P->add_elem(v); });
+    return P;
+}
+
+void KCliques::addCliques(Clique& R, SET_IMPL* P) {
+    pt_counts.local() += P->size();
+    if(!listing) return;
+    string& buffer = pt_buffers.local();
+    string prefix;
+    R.for_each([&](int v) { prefix += to_string(v) + " "; });
+    P->for_each([&](int u) { buffer += prefix + to_string(u) + "\n"; });
+    if(buffer.size() >= LIST_BUFFER_SIZE) flush(buffer);
+}
+
+void KCliques::addClique(Clique& R) {
+    pt_counts.local()++;
+    if(!listing) return;
+    string& buffer = pt_buffers.local();
+    R.for_each([&](int v) { buffer += to_string(v) + " "; });
+    buffer.back() = '\n';
+    if(buffer.size() >= LIST_BUFFER_SIZE) flush(buffer);
+}
+
+void KCliques::flush(string& buffer) {
+    tbb::spin_mutex::scoped_lock lock(list_mutex);
+    list_stream.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+long KCliques::run(int nthr) {
+    tbb::task_scheduler_init init(nthr);
+    pt_counts.clear();
+    GraphGuard *gg = new GraphGuard(oriented);
+    BKTask &rt = *new(tbb::task::allocate_root()) KCliqueRootTask(this, gg);
+    tbb::task::spawn_root_and_wait(rt);
+    delete gg;
+    if(listing) {
+        pt_buffers.combine_each([&](string& buffer) { flush(buffer); });
+        list_stream.flush();
+    }
+    return getCount();
+}
+
+long KCliques::getCount() {
+    long total = 0;
+    pt_counts.combine_each([&](long cnt) { total += cnt; });
+    return total;
+}
+
+/************* k-clique root task *******************/
+tbb::task* KCliqueRootTask::SpawnTask() {
+    Graph* graph = kc->graph;
+    // A root needs at least k-1 successors
+    vector<int> roots;
+    for(int pos = 0; pos < graph->getNodeNo(); pos++) {
+        int vertex = graph->getMappedNode(pos);
+        if(kc->oriented->getAdjacentNodes(vertex)->size() + 1 >= kc->k) roots.push_back(vertex);
+    }
+    set_ref_count(1 + roots.size());
+    tbb::parallel_for(tbb::blocked_range<int>(0, roots.size(), 1), [&](const tbb::blocked_range<int>& r) {
+        for(int i = r.begin(); i != r.end(); ++i) spawn(*new(allocate_child()) KCliqueTask(kc, roots[i], graphg));
+    }, tbb::simple_partitioner());
+    recycle_as_safe_continuation();
+    isContinuation = true;
+    return NULL;
+}
+
+/************* k-clique task *******************/
+tbb::task* KCliqueTask::execute() {
+    if(isContinuation) return NULL;
+    return SpawnTask();
+}
+
+tbb::task* KCliqueTask::SpawnTask() {
+    if(!R_task) {
+        R_task = new Clique(NULL, MemType::ROOT_CLIQUE);
+        R_task->push_back(new_vertex);
+        P_task = kc->rootSet(new_vertex);
+    }
+    set_ref_count(1);
+    expand(*R_task, P_task);
+    P_task = NULL;
+    recycle_as_safe_continuation();
+    isContinuation = true;
+    return NULL;
+}
+
+// Extends R by the vertices of P; large candidate sets become tasks, small ones are
+// expanded sequentially as in MainBKTask. P is deleted.
+void KCliqueTask::expand(Clique& R, SET_IMPL* P) {
+    int k = kc->k;
+    if(R.size() >= k) kc->addClique(R);
+    else if(R.size() + 1 == k) kc->addCliques(R, P);
+    else {
+        P->for_each([&](int u) {
+            SET_IMPL* child = P->intersect(kc->oriented->getAdjacentNodes(u), NULL, MemType::SET);
+            if(R.size() + 1 + child->size() < k) { delete child; return; }
+            if(child->size() >= PX_threshold) {
+                Clique* Rcpy = new Clique(R, MemType::CLIQUE);
+                Rcpy->push_back(u);
+                increment_ref_count();
+                spawn(*new(allocate_child()) KCliqueTask(kc, Rcpy, child, graphg));
+            }
+            else {
+                R.push_back(u);
+                expand(R, child);
+                R.pop_back();
+            }
+        });
+    }
+    delete P;
+}
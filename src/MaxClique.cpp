@@ -0,0 +1,86 @@
+#include <iostream>
+#include <algorithm>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include "MaxClique.h"
+#include "BKTask.h"
+
+using namespace std;
+
+void MaxClique::heuristic(Graph* graph, int nthr) {
+    tbb::task_scheduler_init init(nthr);
+    tbb::parallel_for(tbb::blocked_range<int>(0, graph->getNodeNo()), [&](const tbb::blocked_range<int>& r) {
+        vector<int> clique, cand, next;
+        for(int k = r.begin(); k != r.end(); ++k) {
+            int v = graph->getMappedNode(k);
+            SET_IMPL* adj = graph->getAdjacentNodes(v);
+            if(adj->size() < best_size) continue;
+            // Only the neighbours that would be in P of the root task, as in the enumeration
+            cand.clear();
+            adj->for_each([&](int u) { if(is_root_candidate(graph, v, u)) cand.push_back(u); });
+            clique.assign(1, v);
+            while(!cand.empty() && (int)(clique.size() + cand.size()) > best_size) {
+                int u = *max_element(cand.begin(), cand.end(), [&](int a, int b) {
+                    return graph->getAdjacentNodes(a)->size() < graph->getAdjacentNodes(b)->size();
+                });
+                clique.push_back(u);
+                SET_IMPL* adj_u = graph->getAdjacentNodes(u);
+                next.clear();
+                for(int w : cand) if(w != u && adj_u->contains(w)) next.push_back(w);
+                cand.swap(next);
+            }
+            if((int) clique.size() > best_size) update(clique);
+        }
+    });
+}
+
+void MaxClique::update(const vector<int>& clique) {
+    tbb::spin_mutex::scoped_lock lock(witness_mutex);
+    if((int) clique.size() <= best_size) return;
+    witness = clique;
+    best_size = clique.size();
+    // From now on only strictly larger cliques are of interest
+    SearchBound::raise(best_size + 1);
+}
+
+void MaxClique::offer(UnrolledList& R) {
+    if((int) R.size() <= best_size) return;
+    vector<int> clique;
+    clique.reserve(R.size());
+    R.for_each([&](int v) { clique.push_back(v); });
+    update(clique);
+}
+
+bool MaxClique::colorPrunes(Graph* graph, int r_size, SET_IMPL* P) {
+    if(!coloring) return false;
+    // Every colour class holds at most one vertex of a clique, so P needs this many classes
+    int needed = SearchBound::required - r_size;
+    static thread_local vector<vector<int>> classes;
+    int used = 0;
+    P->for_each([&](int v) {
+        if(used >= needed) return;
+        SET_IMPL* adj = graph->getAdjacentNodes(v);
+        for(int c = 0; c < used; c++) {
+            bool independent = true;
+            for(int u : classes[c]) if(adj->contains(u)) { independent = false; break; }
+            if(independent) { classes[c].push_back(v); return; }
+        }
+        if(used == (int) classes.size()) classes.emplace_back();
+        classes[used++].assign(1, v);
+    });
+    return used < needed;
+}
+
+void MaxClique::printData(ostream& out, bool complete) {
+    vector<int> clique = witness;
+    sort(clique.begin(), clique.end());
+    out << "Maximum clique size: " << best_size;
+    if(!complete) out << " (lower bound, the search was cut by the time limit)";
+    out << "\n";
+    out << "Maximum clique:";
+    for(int v : clique) out << " " << v;
+    out << endl;
+}
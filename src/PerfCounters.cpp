@@ -0,0 +1,139 @@
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "PerfCounters.h"
+
+using namespace std;
+
+#ifdef __linux__
+static int open_event(int event) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    switch(event) {
+        case PERF_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case PERF_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case PERF_LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_DTLB_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+    }
+    // User space only, so that the counters also work with perf_event_paranoid = 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+PerfCounterGroup::PerfCounterGroup() {
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++) {
+#ifdef __linux__
+        fds[i] = open_event(i);
+#else
+        fds[i] = -1;
+#endif
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#ifdef __linux__
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++)
+        if(fds[i] != -1) close(fds[i]);
+#endif
+}
+
+bool PerfCounterGroup::any_open() {
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++)
+        if(fds[i] != -1) return true;
+    return false;
+}
+
+void PerfCounterGroup::read(long long* values) {
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++) {
+        values[i] = -1;
+#ifdef __linux__
+        if(fds[i] == -1) continue;
+        // value, time enabled, time running; scaled up if the counter was multiplexed
+        unsigned long long data[3];
+        if(::read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+        values[i] = (long long)((double) data[0] * data[1] / data[2]);
+#endif
+    }
+}
+
+void PerfCounters::closeGroups() {
+    PerfMutexType::scoped_lock lock(GroupsMutex);
+    for(auto group : groups) delete group;
+    groups.clear();
+}
+
+void PerfCounters::beginPhase() {
+    closeGroups();
+    generation++;
+    active = true;
+    attach_thread();
+}
+
+void PerfCounters::endPhase(string name, bool per_worker) {
+    active = false;
+    long long total[NUM_OF_PERF_EVENTS];
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++) total[i] = -1;
+    vector<vector<long long>> worker_values;
+    bool available = false;
+    {
+        PerfMutexType::scoped_lock lock(GroupsMutex);
+        for(auto group : groups) {
+            available |= group->any_open();
+            vector<long long> values(NUM_OF_PERF_EVENTS);
+            group->read(values.data());
+            for(int i = 0; i < NUM_OF_PERF_EVENTS; i++)
+                if(values[i] != -1) total[i] = (total[i] == -1 ? 0 : total[i]) + values[i];
+            worker_values.push_back(values);
+        }
+    }
+    closeGroups();
+
+    if(!available) {
+        if(!warned) cout << "Hardware counters are not available, check /proc/sys/kernel/perf_event_paranoid" << endl;
+        warned = true;
+        return;
+    }
+    PerfPhase phase;
+    phase.name = name;
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++) phase.total[i] = total[i];
+    if(per_worker) phase.workers = worker_values;
+    phases.push_back(phase);
+
+    print("Hardware counters (" + name + "):", total);
+    if(per_worker && worker_values.size() > 1)
+        for(unsigned int w = 0; w < worker_values.size(); w++)
+            print("   worker " + to_string(w) + ":", worker_values[w].data());
+}
+
+void PerfCounters::print(string label, const long long* values) {
+    cout << label;
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++) {
+        cout << (i ? "; " : " ") << PERF_EVENT_NAMES[i] << " = ";
+        if(values[i] == -1) cout << "n/a"; else cout << values[i];
+    }
+    if(values[PERF_CYCLES] > 0 && values[PERF_INSTRUCTIONS] != -1)
+        cout << "; IPC = " << setprecision(3) << (double) values[PERF_INSTRUCTIONS] / values[PERF_CYCLES] << setprecision(6);
+    cout << endl;
+}
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include "Progress.h"
+#include "BKTask.h"
+
+using namespace std;
+
+void Progress::setRoots(RootIterBKTask* task, Graph* g, const vector<int>& roots) {
+    graph = g;
+    int n = graph->getNodeNo();
+    costs.assign(n, 0);
+    if(pendingRoots) delete[] pendingRoots;
+    pendingRoots = new tbb::atomic<int>[n];
+    for(int pos = 0; pos < n; pos++) pendingRoots[pos] = 0;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, roots.size()), [&](const tbb::blocked_range<size_t>& r) {
+        long local_roots = 0, local_cost = 0;
+        for(size_t k = r.begin(); k != r.end(); ++k) {
+            int pos = roots[k], vertex = graph->getMappedNode(pos);
+            pendingRoots[pos] = task->count_vertex_roots(graph, vertex);
+            if(!pendingRoots[pos]) continue;
+            costs[pos] = max(1L, RootIterBKTask::root_set_cost(graph, vertex));
+            local_roots += pendingRoots[pos];
+            local_cost += costs[pos];
+        }
+        totalRoots += local_roots;
+        totalCost += local_cost;
+    });
+}
+
+void Progress::finishRoot(int vertex, int second_vertex, long root_cliques, bool finished, const vector<long>* histogram) {
+    cliques += root_cliques;
+    if(!finished) return;
+    doneRoots++;
+    if(histogram) {
+        tbb::spin_mutex::scoped_lock lock(HistogramMutex);
+        if(histogram->size() > finishedHistogram.size()) finishedHistogram.resize(histogram->size(), 0);
+        for(size_t size = 0; size < histogram->size(); size++) finishedHistogram[size] += (*histogram)[size];
+    }
+    int pos = graph->getNodePosition(vertex);
+    // An edge root is only a part of its vertex, the cost counts once all of them are done
+    if(pendingRoots[pos].fetch_and_decrement() == 1) doneCost += costs[pos];
+}
+
+vector<int> Progress::getFinishedVertices() {
+    vector<int> vertices;
+    if(!graph) return vertices;
+    for(int pos = 0; pos < graph->getNodeNo(); pos++)
+        if(costs[pos] && pendingRoots[pos] == 0) vertices.push_back(graph->getMappedNode(pos));
+    return vertices;
+}
+
+map<int, long> Progress::getFinishedHistogram() {
+    map<int, long> histogram;
+    for(size_t size = 0; size < finishedHistogram.size(); size++)
+        if(finishedHistogram[size]) histogram[size] = finishedHistogram[size];
+    return histogram;
+}
+
+/****************** Progress line ***********************/
+void Progress::printLine() {
+    double elapsed = (tbb::tick_count::now() - t_start).seconds();
+    long roots = doneRoots, total = totalRoots, done_cost = doneCost, total_cost = totalCost;
+    ostringstream line;
+    line << "Progress: " << roots << "/" << total << " roots";
+    if(total) line << " (" << 100.0 * roots / total << "%)";
+    line << ", " << cliques << " cliques, " << (elapsed > 0 ? cliques / elapsed : 0) << " cliques/s";
+    // The roots finished so far took elapsed seconds for done_cost of the total cost
+    if(done_cost > 0) line << ", ETA " << elapsed * (total_cost - done_cost) / done_cost << "s";
+    cout << line.str() << endl;
+}
+
+void Progress::loop() {
+    std::unique_lock<std::mutex> lock(StopMutex);
+    double next_line = interval;
+    while(!stopped) {
+        double elapsed = (tbb::tick_count::now() - t_start).seconds();
+        double wait = 3600;
+        if(interval > 0) wait = min(wait, next_line - elapsed);
+        if(time_limit > 0 && !TimeBudget::expired) wait = min(wait, time_limit - elapsed);
+        if(wait > 0) stop_cv.wait_for(lock, std::chrono::duration<double>(wait));
+        if(stopped) break;
+        elapsed = (tbb::tick_count::now() - t_start).seconds();
+        if(time_limit > 0 && !TimeBudget::expired && elapsed >= time_limit) {
+            TimeBudget::expired = true;
+            cout << "Time limit of " << time_limit << "s reached, the enumeration is draining" << endl;
+        }
+        if(interval > 0 && elapsed >= next_line) {
+            printLine();
+            while(next_line <= elapsed) next_line += interval;
+        }
+    }
+}
+
+void Progress::start() {
+    TimeBudget::expired = false;
+    t_start = tbb::tick_count::now();
+    if(interval > 0 || time_limit > 0) printer = std::thread([this]() { loop(); });
+}
+
+void Progress::stop() {
+    {
+        std::lock_guard<std::mutex> lock(StopMutex);
+        if(stopped) return;
+        stopped = true;
+    }
+    stop_cv.notify_all();
+    if(printer.joinable()) printer.join();
+}
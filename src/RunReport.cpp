@@ -0,0 +1,151 @@
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <ctime>
+#include <unistd.h>
+
+#include "RunReport.h"
+#include "AlgoStats.h"
+
+using namespace std;
+
+string RunReport::quote(const string& s) {
+    string out = "\"";
+    for(char c : s) {
+        switch(c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if((unsigned char) c < 0x20) { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", c); out += buf; }
+                else out += c;
+        }
+    }
+    return out + "\"";
+}
+
+void RunReport::set(string section, string key, double value) {
+    ostringstream ss;
+    ss.precision(9);
+    ss << value;
+    setRaw(section, key, ss.str());
+}
+
+void RunReport::setRaw(string section, string key, string json) {
+    for(auto& sec : sections) {
+        if(sec.first != section) continue;
+        for(auto& entry : sec.second)
+            if(entry.first == key) { entry.second = json; return; }
+        sec.second.push_back(make_pair(key, json));
+        return;
+    }
+    sections.push_back(make_pair(section, Section(1, make_pair(key, json))));
+}
+
+void RunReport::addHardwareInfo() {
+    char host[256] = {0};
+    if(gethostname(host, sizeof(host) - 1) == 0) set("hardware", "hostname", string(host));
+    set("hardware", "hardware_threads", (unsigned int) std::thread::hardware_concurrency());
+    long pages = sysconf(_SC_PHYS_PAGES), page_size = sysconf(_SC_PAGE_SIZE);
+    if(pages > 0 && page_size > 0) set("hardware", "memory_kb", pages / 1024 * page_size);
+
+    ifstream cpuinfo("/proc/cpuinfo");
+    string line;
+    while(getline(cpuinfo, line)) {
+        if(line.compare(0, 10, "model name") != 0) continue;
+        size_t colon = line.find(':');
+        if(colon != string::npos) set("hardware", "cpu", line.substr(line.find_first_not_of(' ', colon + 1)));
+        break;
+    }
+#ifdef __VERSION__
+    set("hardware", "compiler", string(__VERSION__));
+#endif
+#ifdef __AVX512F__
+    set("hardware", "avx512", true);
+#else
+    set("hardware", "avx512", false);
+#endif
+    set("hardware", "timestamp", (long) time(NULL));
+}
+
+void RunReport::addCliqueHistogram(const map<int, long>& histogram, const map<int, double>& first_found) {
+    long total = 0;
+    string json = "{";
+    for(auto& pair : histogram) {
+        if(json.size() > 1) json += ", ";
+        json += quote(to_string(pair.first)) + ": " + to_string(pair.second);
+        total += pair.second;
+    }
+    set("cliques", "total", total);
+    setRaw("cliques", "histogram", json + "}");
+    if(first_found.empty()) return;
+    json = "{";
+    for(auto& pair : first_found) {
+        if(json.size() > 1) json += ", ";
+        ostringstream ss;
+        ss.precision(6);
+        ss << pair.second;
+        json += quote(to_string(pair.first)) + ": " + ss.str();
+    }
+    setRaw("cliques", "first_found_s", json + "}");
+}
+
+void RunReport::addMemoryUsage(MemUsageLogger* logger) {
+    set("memory", "peak_kb", logger->getPeakUsage() / 1024);
+    string json = "{";
+    for(int i = 0; i < MemType::NUM_OF_TYPES; i++) {
+        if(i) json += ", ";
+        json += quote(TYPE_NAMES[i]) + ": " + to_string(logger->getPeakUsage(i) / 1024);
+    }
+    setRaw("memory", "peak_kb_per_type", json + "}");
+}
+
+static string perf_values_json(const long long* values) {
+    string json = "{";
+    for(int i = 0; i < NUM_OF_PERF_EVENTS; i++) {
+        if(i) json += ", ";
+        json += RunReport::quote(PERF_EVENT_NAMES[i]) + ": " + (values[i] == -1 ? string("null") : to_string(values[i]));
+    }
+    return json + "}";
+}
+
+void RunReport::addPerfCounters(PerfCounters* counters) {
+    for(auto& phase : counters->getPhases()) {
+        string json = perf_values_json(phase.total);
+        if(!phase.workers.empty()) {
+            json.pop_back();
+            json += ", \"workers\": [";
+            for(unsigned int w = 0; w < phase.workers.size(); w++)
+                json += (w ? ", " : "") + perf_values_json(phase.workers[w].data());
+            json += "]}";
+        }
+        setRaw("hardware_counters", phase.name, json);
+    }
+}
+
+void RunReport::addAlgoStats() {
+    AlgoStats total = combinedAlgoStats();
+    for(int i = 0; i < NUM_OF_ALGO_COUNTERS; i++) set("algorithm_counters", ALGO_COUNTER_NAMES[i], total.counters[i]);
+    for(int h = 0; h < NUM_OF_ALGO_HISTOGRAMS; h++) {
+        int last = 0;
+        for(int b = 0; b < ALGO_HIST_BUCKETS; b++) if(total.hist[h][b]) last = b;
+        string json = "[";
+        for(int b = 0; b <= last; b++) json += (b ? ", " : "") + to_string(total.hist[h][b]);
+        setRaw("algorithm_histograms_log2", ALGO_HISTOGRAM_NAMES[h], json + "]");
+    }
+}
+
+void RunReport::writeData() {
+    ofstream out(out_file_name);
+    out << "{\n";
+    for(unsigned int s = 0; s < sections.size(); s++) {
+        out << "  " << quote(sections[s].first) << ": {\n";
+        const Section& sec = sections[s].second;
+        for(unsigned int k = 0; k < sec.size(); k++)
+            out << "    " << quote(sec[k].first) << ": " << sec[k].second << (k + 1 < sec.size() ? ",\n" : "\n");
+        out << "  }" << (s + 1 < sections.size() ? ",\n" : "\n");
+    }
+    out << "}\n";
+    cout << "Run report written to " << out_file_name << endl;
+}
@@ -0,0 +1,221 @@
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/tick_count.h>
+#include <tbb/combinable.h>
+
+#include "Server.h"
+#include "BKTask.h"
+#include "utils.h"
+
+using namespace std;
+
+extern tbb::combinable<Histogram> pt_hist;
+extern bool noEndPrint;
+
+/****************** Socket ***********************/
+// Requests are served one at a time, so a client gets this long to send its request line (and to
+// take the response) before its connection is dropped and the next one is accepted
+const int CLIENT_TIMEOUT_MS = 5000;
+
+// False if the client closed the connection or did not finish the line before the deadline
+static bool read_line(int fd, string& line) {
+    line.clear();
+    char c;
+    auto start = tbb::tick_count::now();
+    while(true) {
+        int left = CLIENT_TIMEOUT_MS - (int) ((tbb::tick_count::now() - start).seconds() * 1000);
+        pollfd pfd = {fd, POLLIN, 0};
+        int ready = left > 0 ? poll(&pfd, 1, left) : 0;
+        if(ready < 0 && errno == EINTR) continue;
+        if(ready <= 0) return false;
+        ssize_t n = recv(fd, &c, 1, 0);
+        if(n < 0 && errno == EINTR) continue;
+        if(n <= 0) return !line.empty();
+        if(c == '\n') return true;
+        line += c;
+    }
+}
+
+static void write_all(int fd, const string& data) {
+    size_t sent = 0;
+    while(sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if(n < 0 && errno == EINTR) continue;
+        if(n <= 0) return;
+        sent += n;
+    }
+}
+
+bool MceServer::run() {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(fd < 0 || socket_path.size() >= sizeof(addr.sun_path)) {
+        cout << "Cannot open the socket " << socket_path << endl;
+        if(fd >= 0) close(fd);
+        return false;
+    }
+    strcpy(addr.sun_path, socket_path.c_str());
+    unlink(socket_path.c_str());
+    if(bind(fd, (sockaddr*) &addr, sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        cout << "Cannot open the socket " << socket_path << ": " << strerror(errno) << endl;
+        close(fd);
+        return false;
+    }
+
+    // The worker threads stay alive between the requests
+    tbb::task_scheduler_init init(nthr);
+    settings = Autotuner::current();
+    noEndPrint = true;
+    cout << "Serving on " << socket_path << endl;
+
+    bool shutdown = false;
+    while(!shutdown) {
+        int conn = accept(fd, NULL, NULL);
+        if(conn < 0) {
+            if(errno == EINTR) continue;
+            cout << "accept failed: " << strerror(errno) << endl;
+            break;
+        }
+        // A client that does not read the response does not block the server either
+        timeval send_timeout = {CLIENT_TIMEOUT_MS / 1000, (CLIENT_TIMEOUT_MS % 1000) * 1000};
+        setsockopt(conn, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+        string request;
+        if(!read_line(conn, request)) cout << "Connection dropped without a complete request" << endl;
+        else {
+            auto tick0 = tbb::tick_count::now();
+            string response = handle(request, shutdown);
+            write_all(conn, response);
+            cout << "Request \"" << request << "\" served in " << (tbb::tick_count::now() - tick0).seconds() << "s" << endl;
+        }
+        close(conn);
+    }
+    close(fd);
+    unlink(socket_path.c_str());
+    noEndPrint = false;
+    return true;
+}
+
+/****************** Requests ***********************/
+void MceServer::applyOptions(char** begin, char** end) {
+    TunedSettings s = settings;
+    if(cmdOptionExists(begin, end, "-s")) s.subgraphBased = min(2, max(0, stoi(string(getCmdOption(begin, end, "-s")))));
+    if(cmdOptionExists(begin, end, "--thresh")) s.PX_threshold = stoi(string(getCmdOption(begin, end, "--thresh")));
+    if(cmdOptionExists(begin, end, "-o")) s.setsMempool = true;
+    if(cmdOptionExists(begin, end, "--mem-thresh")) s.mem_threshold = stoi(string(getCmdOption(begin, end, "--mem-thresh")));
+    if(cmdOptionExists(begin, end, "-b")) s.memBlockSize = stoi(string(getCmdOption(begin, end, "-b")));
+    Autotuner::set(s);
+    // Only the search is bounded, the shared graph is never pruned to a core
+    if(cmdOptionExists(begin, end, "--min-clq")) SearchBound::raise(stoi(string(getCmdOption(begin, end, "--min-clq"))));
+}
+
+void MceServer::enumerate(ostream& out) {
+    auto tick0 = tbb::tick_count::now();
+    graph->BronKerboschDegeneracy(nthr);
+    double runtime = (tbb::tick_count::now() - tick0).seconds();
+    map<int, long> histogram = Graph::cliqueHistogram(pt_hist);
+    long total = 0;
+    for(auto& hist : histogram) total += hist.second;
+    out << "# Number of maximal cliques: " << total << "\n";
+    out << "# Clique histogram:\n";
+    out << "# clique_size, num_of_cliques\n";
+    for(auto& hist : histogram) out << hist.first << ", " << hist.second << "\n";
+    out << "# Runtime: " << runtime << "s\n";
+}
+
+string MceServer::handle(const string& request, bool& shutdown) {
+    vector<string> words;
+    stringstream ss(request);
+    string word;
+    while(ss >> word) words.push_back(word);
+    if(words.empty()) return "error: empty request\n";
+    vector<char*> args;
+    for(auto& w : words) args.push_back(&w[0]);
+    char **begin = args.data(), **end = args.data() + args.size();
+    const string& cmd = words[0];
+
+    pt_hist.clear();
+    BKTask::reset_task_count();
+    SearchBound::required = 0;
+    ostringstream out;
+    try {
+        if(cmd == "enumerate") {
+            applyOptions(begin, end);
+            enumerate(out);
+        }
+        else if(cmd == "query") {
+            if(words.size() < 2) throw invalid_argument("query needs a list of vertices");
+            vector<int> vertices;
+            for(size_t k = 1; k < words.size(); k++)
+                for(int v : VertexQueries::parse(words[k])) vertices.push_back(v);
+            vertexQueries = new VertexQueries(graph, vertices);
+            auto tick0 = tbb::tick_count::now();
+            vertexQueries->run(nthr);
+            double runtime = (tbb::tick_count::now() - tick0).seconds();
+            vertexQueries->writeData(out);
+            out << "# Number of queries: " << vertexQueries->getVertices().size() << "; maximal cliques: "
+                << vertexQueries->getCliqueCount() << "; runtime: " << runtime << "s\n";
+        }
+        else if(cmd == "topk") {
+            if(words.size() < 2) throw invalid_argument("topk needs K");
+            applyOptions(begin, end);
+            topK = new TopKCliques(max(1, stoi(words[1])));
+            graph->BronKerboschDegeneracy(nthr);
+            topK->writeData(out);
+        }
+        else if(cmd == "maxclique") {
+            applyOptions(begin, end);
+            maxClique = new MaxClique(cmdOptionExists(begin, end, "--color-bound"));
+            maxClique->heuristic(graph, nthr);
+            graph->BronKerboschDegeneracy(nthr);
+            maxClique->printData(out);
+        }
+        else if(cmd == "kclique") {
+            if(words.size() < 2) throw invalid_argument("kclique needs k");
+            int k = max(1, stoi(words[1]));
+            if(!kcliques) kcliques = new KCliques(graph, k, nthr);
+            kcliques->k = k;
+            auto tick0 = tbb::tick_count::now();
+            long count = kcliques->run(nthr);
+            out << "Number of " << k << "-cliques: " << count << "; runtime: " << (tbb::tick_count::now() - tick0).seconds() << "s\n";
+        }
+        else if(cmd == "info") {
+            out << "vertices: " << graph->getNodeNo() << "\n";
+            out << "edges: " << graph->getEdgeNo() << "\n";
+            out << "max_degree: " << graph->maxdeg << "\n";
+            out << "degeneracy: " << graph->degeneracy << "\n";
+            out << "threads: " << nthr << "\n";
+        }
+        else if(cmd == "shutdown") {
+            shutdown = true;
+            out << "bye\n";
+        }
+        else out << "error: unknown request " << cmd << "\n";
+    }
+    catch(const exception& e) {
+        out.str("");
+        out << "error: " << e.what() << "\n";
+    }
+
+    // Nothing of a request is kept for the next one
+    if(vertexQueries) delete vertexQueries; vertexQueries = NULL;
+    if(topK) delete topK; topK = NULL;
+    if(maxClique) delete maxClique; maxClique = NULL;
+    SearchBound::required = 0;
+    Autotuner::set(settings);
+    return out.str();
+}
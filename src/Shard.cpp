@@ -0,0 +1,124 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/blocked_range.h>
+
+#include "Shard.h"
+#include "BKTask.h"
+
+using namespace std;
+
+bool ShardPlan::parse(string spec, int& index, int& count) {
+    size_t slash = spec.find('/');
+    if(slash == string::npos) return false;
+    index = stoi(spec.substr(0, slash));
+    count = stoi(spec.substr(slash + 1));
+    return count > 0 && index >= 0 && index < count;
+}
+
+void ShardPlan::assign(int nthr) {
+    int n = graph->getNodeNo();
+    vector<pair<long, int>> order(n);
+    {
+        tbb::task_scheduler_init init(nthr);
+        tbb::parallel_for(tbb::blocked_range<int>(0, n), [&](const tbb::blocked_range<int>& r) {
+            // Unlike the sampled estimates of --root-cost, the sizes of the root sets do not depend
+            // on the iteration order of the sets, so all processes agree on them
+            for(int pos = r.begin(); pos != r.end(); ++pos)
+                order[pos] = make_pair(RootIterBKTask::root_set_cost(graph, graph->getMappedNode(pos)), pos);
+        });
+        tbb::parallel_sort(order.begin(), order.end(), [&](const pair<long, int>& a, const pair<long, int>& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+    }
+
+    // Longest processing time first; ties go to the shard with the lowest index, so that every
+    // process arrives at the same assignment
+    typedef pair<long, int> Load;
+    priority_queue<Load, vector<Load>, greater<Load>> loads;
+    for(int k = 0; k < count; k++) loads.push(make_pair(0L, k));
+    roots.clear();
+    cost = totalCost = 0;
+    for(auto& root : order) {
+        Load least = loads.top(); loads.pop();
+        // Every root costs at least 1, otherwise the roots without P would all go to one shard
+        long c = max(1L, root.first);
+        if(least.second == index) { roots.push_back(root.second); cost += c; }
+        totalCost += c;
+        loads.push(make_pair(least.first + c, least.second));
+    }
+    sort(roots.begin(), roots.end());
+}
+
+/****************** Partial results ***********************/
+void ShardPlan::writeResult(string path, const map<int, long>& histogram, double runtime) {
+    ofstream out(path);
+    out << "mce-shard " << index << " " << count << " " << graph->getNodeNo() << " " << graph->getEdgeNo() << " "
+        << Checkpoint::runChecksum(graph) << "\n";
+    out << "roots " << roots.size() << " cost " << cost << " " << totalCost << "\n";
+    out << "time " << runtime << "\n";
+    out << "histogram " << histogram.size();
+    for(auto& hist : histogram) out << " " << hist.first << " " << hist.second;
+    out << "\n";
+}
+
+bool ShardPlan::merge(const vector<string>& paths, ostream& out, bool partial) {
+    map<int, long> histogram;
+    vector<bool> seen;
+    int count = -1;
+    long nodes = 0, edges = 0, roots = 0;
+    uint64_t checksum = 0;
+    double max_time = 0, sum_time = 0;
+    for(auto& path : paths) {
+        ifstream in(path);
+        string magic, key;
+        int i, n;
+        long v, e, r, c, total, sizes;
+        uint64_t sum;
+        double runtime;
+        in >> magic >> i >> n >> v >> e >> sum >> key >> r >> key >> c >> total >> key >> runtime >> key >> sizes;
+        if(!in || magic != "mce-shard") { cout << "Cannot read the shard result " << path << endl; return false; }
+        if(count == -1) { count = n; nodes = v; edges = e; checksum = sum; seen.assign(n, false); }
+        if(n != count || v != nodes || e != edges || sum != checksum) {
+            cout << "The shard result " << path << " is of another graph, settings or number of shards" << endl;
+            return false;
+        }
+        if(i < 0 || i >= count || seen[i]) { cout << "Shard " << i << " is given twice" << endl; return false; }
+        seen[i] = true;
+        for(long k = 0; k < sizes; k++) {
+            int size; long cliques;
+            in >> size >> cliques;
+            histogram[size] += cliques;
+        }
+        if(!in) { cout << "The shard result " << path << " is truncated" << endl; return false; }
+        roots += r;
+        max_time = max(max_time, runtime);
+        sum_time += runtime;
+        cout << "Shard " << i << "/" << n << ": " << r << " roots, estimated cost " << c << " of " << total << ", " << runtime << "s" << endl;
+    }
+    int missing = 0;
+    for(int i = 0; i < count; i++) {
+        if(seen[i]) continue;
+        cout << (partial ? "Warning: the" : "The") << " result of shard " << i << "/" << count << " is missing" << endl;
+        missing++;
+    }
+    if(missing && !partial) { cout << "The merge is incomplete, --merge-partial prints the histogram of the given shards" << endl; return false; }
+    if(count > 0) cout << "Slowest shard: " << max_time << "s; mean: " << sum_time / paths.size() << "s" << endl;
+
+    long total = 0;
+    for(auto& hist : histogram) total += hist.second;
+    if(missing) out << "# Partial merge: " << count - missing << " of " << count << " shards\n";
+    out << "# Number of maximal cliques: " << total << "\n";
+    out << "# Clique histogram:\n";
+    out << "# clique_size, num_of_cliques\n";
+    for(auto& hist : histogram) out << hist.first << ", " << hist.second << "\n";
+    out.flush();
+    return true;
+}
@@ -0,0 +1,49 @@
+#include <iostream>
+#include <fstream>
+
+#include "TaskTrace.h"
+
+using namespace std;
+
+void TaskTracer::writeData() {
+    ofstream out(out_file_name);
+    out.precision(3);
+    out << fixed;
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"mce\"}}";
+    long dropped = 0, async_id = 0;
+    TraceMutexType::scoped_lock lock(BuffersMutex);
+    for(auto buffer : buffers) {
+        out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << buffer->tid
+            << ", \"args\": {\"name\": \"worker " << buffer->tid << "\"}}";
+        size_t count = buffer->wrapped ? buffer->records.size() : buffer->next;
+        size_t first = buffer->wrapped ? buffer->next : 0;
+        if(buffer->wrapped) dropped++;
+        for(size_t k = 0; k < count; k++) {
+            const TraceRecord& rec = buffer->records[(first + k) % buffer->records.size()];
+            if(rec.type == TRACE_ROOT_SUBTREE) {
+                // Root subtrees span several workers, so they are shown as async slices
+                string name = TRACE_NAMES[rec.type] + " " + to_string(rec.arg);
+                if(rec.arg2 != -1) name += "-" + to_string(rec.arg2);
+                out << ",\n{\"name\": \"" << name << "\", \"cat\": \"root\", \"ph\": \"b\", \"id\": " << async_id
+                    << ", \"pid\": 0, \"tid\": " << buffer->tid << ", \"ts\": " << rec.begin << "}";
+                out << ",\n{\"name\": \"" << name << "\", \"cat\": \"root\", \"ph\": \"e\", \"id\": " << async_id
+                    << ", \"pid\": 0, \"tid\": " << buffer->tid << ", \"ts\": " << rec.end << "}";
+                async_id++;
+                continue;
+            }
+            out << ",\n{\"name\": \"" << TRACE_NAMES[rec.type] << "\", \"cat\": \"mce\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+                << buffer->tid << ", \"ts\": " << rec.begin << ", \"dur\": " << rec.end - rec.begin;
+            if(rec.arg != -1) {
+                out << ", \"args\": {\"vertex\": " << rec.arg;
+                if(rec.arg2 != -1) out << ", \"second\": " << rec.arg2;
+                out << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    cout << "Task trace written to " << out_file_name << " (" << buffers.size() << " workers";
+    if(dropped) cout << ", " << dropped << " ring buffers wrapped, the oldest events were dropped";
+    cout << ")" << endl;
+}
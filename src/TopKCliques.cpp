@@ -0,0 +1,42 @@
+#include <iostream>
+#include <algorithm>
+
+#include "TopKCliques.h"
+#include "BKTask.h"
+
+using namespace std;
+
+void TopKCliques::offer(UnrolledList& R) {
+    CliqueHeap& heap = pt_heaps.local();
+    if((int) heap.size() == k && R.size() <= heap.top().size()) return;
+    vector<int> clique;
+    clique.reserve(R.size());
+    R.for_each([&](int v) { clique.push_back(v); });
+    if((int) heap.size() == k) heap.pop();
+    heap.push(clique);
+    if((int) heap.size() == k) SearchBound::raise(heap.top().size() + 1);
+}
+
+vector<vector<int>> TopKCliques::getCliques() {
+    vector<vector<int>> cliques;
+    pt_heaps.combine_each([&](CliqueHeap heap) {
+        for(; !heap.empty(); heap.pop()) cliques.push_back(heap.top());
+    });
+    stable_sort(cliques.begin(), cliques.end(), [](const vector<int>& a, const vector<int>& b) { return a.size() > b.size(); });
+    if((int) cliques.size() > k) cliques.resize(k);
+    for(auto& clique : cliques) sort(clique.begin(), clique.end());
+    return cliques;
+}
+
+void TopKCliques::writeData(ostream& out, bool complete) {
+    vector<vector<int>> cliques = getCliques();
+    out << "# Top " << k << " maximal cliques: " << cliques.size();
+    if(!complete) out << " (incomplete, the search was cut by the time limit)";
+    out << "\n";
+    out << "# clique_size: vertices\n";
+    for(auto& clique : cliques) {
+        out << clique.size() << ":";
+        for(int v : clique) out << " " << v;
+        out << "\n";
+    }
+}
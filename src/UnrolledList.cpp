@@ -89,10 +89,10 @@ void UnrolledList::kill_list(){
     offset = 0; num_of_elems = 0; num_of_buckets = 0;
 }
 
-std::pair<UnrolledList::Bucket*, UnrolledList::Bucket*> UnrolledList::copy_list(MemChunk *chunk) {
+std::pair<UnrolledList::Bucket*, UnrolledList::Bucket*> UnrolledList::copy_list(MemChunk *chunk, int type) {
     Bucket *new_head = NULL, *new_tail = NULL, *pom = head;
     while(NULL != pom) {
-        Bucket *novi = create_bucket(chunk, mem_type);
+        Bucket *novi = create_bucket(chunk, type);
         if(!new_head) new_head = novi;
         else new_tail->next = novi;
         new_tail = novi;
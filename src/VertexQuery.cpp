@@ -0,0 +1,81 @@
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+
+#include "VertexQuery.h"
+
+using namespace std;
+
+VertexQueries::VertexQueries(Graph* g, const vector<int>& _vertices) : graph(g) {
+    for(int v : _vertices) {
+        if(!graph->hasNode(v)) { cout << "Query vertex " << v << " is not in the graph" << endl; continue; }
+        if(find(vertices.begin(), vertices.end(), v) != vertices.end()) continue;
+        vertices.push_back(v);
+        positions.push_back(graph->getNodePosition(v));
+    }
+}
+
+vector<int> VertexQueries::parse(string spec) {
+    vector<int> vertices;
+    ifstream file(spec);
+    if(file.good()) {
+        int v;
+        while(file >> v) vertices.push_back(v);
+        return vertices;
+    }
+    stringstream ss(spec);
+    string item;
+    while(getline(ss, item, ',')) if(!item.empty()) vertices.push_back(stoi(item));
+    return vertices;
+}
+
+void VertexQueries::run(int nthr) {
+    pt_cliques.clear();
+    pt_runtimes.clear();
+    if(!positions.empty()) graph->BronKerboschDegeneracy(nthr, &positions);
+}
+
+void VertexQueries::addClique(int query, UnrolledList& R) {
+    vector<int>& local = pt_cliques.local();
+    local.push_back(query);
+    local.push_back(R.size());
+    R.for_each([&](int v) { local.push_back(v); });
+}
+
+void VertexQueries::finishQuery(int query, double runtime) {
+    pt_runtimes.local().push_back(make_pair(query, runtime));
+}
+
+long VertexQueries::getCliqueCount() {
+    long count = 0;
+    pt_cliques.combine_each([&](const vector<int>& local) {
+        for(size_t i = 0; i < local.size(); i += 2 + local[i + 1]) count++;
+    });
+    return count;
+}
+
+void VertexQueries::writeData(ostream& out) {
+    map<int, vector<vector<int>>> cliques;
+    pt_cliques.combine_each([&](const vector<int>& local) {
+        for(size_t i = 0; i < local.size(); i += 2 + local[i + 1]) {
+            vector<int> clique(local.begin() + i + 2, local.begin() + i + 2 + local[i + 1]);
+            sort(clique.begin(), clique.end());
+            cliques[local[i]].push_back(clique);
+        }
+    });
+    map<int, double> runtimes;
+    pt_runtimes.combine_each([&](const vector<pair<int, double>>& local) { for(auto& rec : local) runtimes[rec.first] = rec.second; });
+
+    for(int v : vertices) {
+        vector<vector<int>>& list = cliques[v];
+        sort(list.begin(), list.end());
+        out << "# Query " << v << ": " << list.size() << " maximal cliques in " << runtimes[v] << "s\n";
+        for(auto& clique : list) {
+            out << v << ":";
+            for(int u : clique) out << " " << u;
+            out << "\n";
+        }
+    }
+    out.flush();
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include "VertexStats.h"
+
+using namespace std;
+
+VertexStats::VertexStats(Graph* g, string _out_file_name) :
+    graph(g), id_range(0), out_file_name(_out_file_name), generation(next_generation())
+{
+    for(int pos = 0; pos < graph->getNodeNo(); pos++) id_range = max(id_range, (size_t) graph->getMappedNode(pos) + 1);
+}
+
+void VertexStats::writeData(int nthr) {
+    tbb::task_scheduler_init init(nthr);
+    // Merge the counters of all workers into the first one
+    VertexCounters total(workers.empty() ? id_range : 0);
+    VertexCounters& merged = workers.empty() ? total : *workers[0];
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, id_range, 4096), [&](const tbb::blocked_range<size_t>& r) {
+        for(size_t w = 1; w < workers.size(); w++) {
+            for(size_t v = r.begin(); v != r.end(); ++v) {
+                merged.cliques[v] += workers[w]->cliques[v];
+                merged.max_size[v] = max(merged.max_size[v], workers[w]->max_size[v]);
+            }
+        }
+    });
+
+    vector<int> vertices(graph->getNodeNo());
+    for(int pos = 0; pos < graph->getNodeNo(); pos++) vertices[pos] = graph->getMappedNode(pos);
+    sort(vertices.begin(), vertices.end());
+    ofstream out(out_file_name);
+    out << "vertex, cliques, max_clique_size\n";
+    string buffer;
+    for(int v : vertices) {
+        buffer += to_string(v) + ", " + to_string(merged.cliques[v]) + ", " + to_string(merged.max_size[v]) + "\n";
+        if(buffer.size() >= (1 << 20)) { out << buffer; buffer.clear(); }
+    }
+    out << buffer;
+    cout << "Vertex clique statistics written to " << out_file_name << endl;
+}
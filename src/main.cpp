@@ -1,5 +1,7 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 
 #include <immintrin.h>
 #include <cstdint>
@@ -12,6 +14,24 @@
 #include "Graph.h"
 #include "utils.h"
 #include "MemUsageLogger.h"
+#include "RootLog.h"
+#include "TaskTrace.h"
+#include "PerfCounters.h"
+#include "AlgoStats.h"
+#include "RunReport.h"
+#include "BKTask.h"
+#include "Autotune.h"
+#include "BenchDriver.h"
+#include "MaxClique.h"
+#include "TopKCliques.h"
+#include "KClique.h"
+#include "VertexStats.h"
+#include "VertexQuery.h"
+#include "Server.h"
+#include "Batch.h"
+#include "Checkpoint.h"
+#include "Shard.h"
+#include "Progress.h"
 
 #define DATAPATH string("data/")
 #define RESPATH  string("results/cliques/")
@@ -30,14 +50,54 @@ bool setsMempool = false;
 int PX_threshold = 30;
 int mem_threshold = 20;
 int max_clq_size = -1;
+int min_clq_size = -1;
 int subgraphBased = 0;
 unsigned int memBlockSize = 20480;
 
+// Root scheduling
+int root_cost_mode = 0;
+int eager_roots = 0;
+RootLog *rootLog = NULL;
+RootSizeStats *rootStats = NULL;
+bool idleSplit = false;
+bool edgeRoots = false;
+bool noEndPrint = false;
+
+// Task timeline
+TaskTracer *taskTracer = NULL;
+
+// Hardware counters
+PerfCounters *perfCounters = NULL;
+
+// Maximum clique search
+MaxClique *maxClique = NULL;
+TopKCliques *topK = NULL;
+
+// Per-vertex clique statistics
+VertexStats *vertexStats = NULL;
+
+// Vertex queries
+VertexQueries *vertexQueries = NULL;
+
+// Checkpoint and resume
+Checkpoint *checkpoint = NULL;
+
+// Progress line and time limit
+Progress *progress = NULL;
+
 int main(int argc, char** argv) {
     if(cmdOptionExists(argv, argv+argc, "-h") || cmdOptionExists(argv, argv+argc, "--help")) {
         printHelp(); return 0;
     }
 
+    if(cmdOptionExists(argv, argv+argc, "--merge")) {
+        vector<string> paths;
+        stringstream ss(string(getCmdOption(argv, argv + argc, "--merge")));
+        string item;
+        while(getline(ss, item, ',')) if(!item.empty()) paths.push_back(item);
+        return ShardPlan::merge(paths, cout, cmdOptionExists(argv, argv+argc, "--merge-partial")) ? 0 : 1;
+    }
+
     char* rp = getenv("PROJECT_ROOT");
 	string root_path;
 	if(rp != NULL) root_path = string(rp); else root_path = string("..");
@@ -45,11 +105,14 @@ int main(int argc, char** argv) {
     // Read path
 	string path = root_path + "/" + DATAPATH + "simple.mtx";
     if(cmdOptionExists(argv, argv+argc, "-f")) path = string(getCmdOption(argv, argv + argc, "-f"));
+    bool fromSnapshot = cmdOptionExists(argv, argv+argc, "--snapshot");
+    if(fromSnapshot) path = string(getCmdOption(argv, argv + argc, "--snapshot"));
 	string name = path.substr(path.find_last_of("/"), path.find_last_of(".")-path.find_last_of("/"));
 
     // TODO: Check if the file exists
     struct stat buffer;
-    if(stat(path.c_str(), &buffer) != 0) {
+    bool batchMode = cmdOptionExists(argv, argv+argc, "--batch");
+    if(!batchMode && stat(path.c_str(), &buffer) != 0) {
         cout << "The input file doesn't exist" << endl; return 0;
     }
 
@@ -57,7 +120,7 @@ int main(int argc, char** argv) {
 	int nthr = 256;
     if(cmdOptionExists(argv, argv+argc, "-n")) nthr = stoi(string(getCmdOption(argv, argv + argc, "-n")));
 
-    long sampling_int = 100000;
+    long sampling_int = 10;
     if(cmdOptionExists(argv, argv+argc, "-o")) {
         setsMempool = true;
         if(cmdOptionExists(argv, argv+argc, "-b")) memBlockSize = stoi(string(getCmdOption(argv, argv + argc, "-b")));
@@ -78,38 +141,434 @@ int main(int argc, char** argv) {
     if(cmdOptionExists(argv, argv+argc, "--thresh")) PX_threshold = stoi(string(getCmdOption(argv, argv + argc, "--thresh")));
     if(cmdOptionExists(argv, argv+argc, "--mem-thresh")) mem_threshold = stoi(string(getCmdOption(argv, argv + argc, "--mem-thresh")));
     if(cmdOptionExists(argv, argv+argc, "--max-clq")) max_clq_size = stoi(string(getCmdOption(argv, argv + argc, "--max-clq")));
+    if(cmdOptionExists(argv, argv+argc, "--min-clq")) min_clq_size = stoi(string(getCmdOption(argv, argv + argc, "--min-clq")));
     if(cmdOptionExists(argv, argv+argc, "-s")) {
         subgraphBased = stoi(string(getCmdOption(argv, argv + argc, "-s")));
         if(subgraphBased > 2 || subgraphBased < 0) subgraphBased == 0;
     }
 
+    if(cmdOptionExists(argv, argv+argc, "--root-cost")) {
+        root_cost_mode = stoi(string(getCmdOption(argv, argv + argc, "--root-cost")));
+        if(root_cost_mode > 3 || root_cost_mode < 0) root_cost_mode = 0;
+        eager_roots = nthr;
+    }
+    if(cmdOptionExists(argv, argv+argc, "--eager-roots")) eager_roots = stoi(string(getCmdOption(argv, argv + argc, "--eager-roots")));
+    if(cmdOptionExists(argv, argv+argc, "--idle-split")) idleSplit = true;
+    if(cmdOptionExists(argv, argv+argc, "--edge-roots")) edgeRoots = true;
+    if(cmdOptionExists(argv, argv+argc, "--root-stats")) rootStats = new RootSizeStats;
+    if(cmdOptionExists(argv, argv+argc, "--root-log")) rootLog = new RootLog(string(getCmdOption(argv, argv + argc, "--root-log")));
+    if(cmdOptionExists(argv, argv+argc, "--trace")) {
+        size_t trace_buffer = 65536;
+        if(cmdOptionExists(argv, argv+argc, "--trace-buffer")) trace_buffer = stol(string(getCmdOption(argv, argv + argc, "--trace-buffer")));
+        taskTracer = new TaskTracer(string(getCmdOption(argv, argv + argc, "--trace")), max((size_t)1, trace_buffer));
+    }
+    if(cmdOptionExists(argv, argv+argc, "--perf")) perfCounters = new PerfCounters;
+    RunReport *report = NULL;
+    if(cmdOptionExists(argv, argv+argc, "--report")) report = new RunReport(string(getCmdOption(argv, argv + argc, "--report")));
+
+	Graph *g = NULL;
+	auto release = [&]() {
+        delete g; g = NULL;
+        if(memLogger) delete memLogger; memLogger = NULL;
+        if(rootLog) delete rootLog; rootLog = NULL;
+        if(rootStats) delete rootStats; rootStats = NULL;
+        if(taskTracer) delete taskTracer; taskTracer = NULL;
+        if(perfCounters) delete perfCounters; perfCounters = NULL;
+	};
+
+    if(batchMode) {
+        long large_edges = 100000;
+        if(cmdOptionExists(argv, argv+argc, "--batch-large")) large_edges = stol(string(getCmdOption(argv, argv + argc, "--batch-large")));
+        BatchRunner batch(nthr, large_edges);
+        ofstream batch_file;
+        if(cmdOptionExists(argv, argv+argc, "--batch-out")) batch_file.open(string(getCmdOption(argv, argv + argc, "--batch-out")));
+        auto tick0 = tbb::tick_count::now();
+        bool done = batch.run(string(getCmdOption(argv, argv + argc, "--batch")), batch_file.is_open() ? batch_file : cout);
+        double runtime = (tbb::tick_count::now() - tick0).seconds();
+        if(done) {
+            cout << "Batch: " << batch.getGraphCount() << " graphs (" << batch.getLargeCount() << " on the task tree), "
+                 << batch.getCliqueCount() << " maximal cliques in " << runtime << "s; "
+                 << batch.getGraphCount() / runtime << " graphs/s" << endl;
+            if(report) {
+                report->set("config", "threads", nthr);
+                report->set("batch", "graphs", batch.getGraphCount());
+                report->set("batch", "large_graphs", batch.getLargeCount());
+                report->set("batch", "cliques", batch.getCliqueCount());
+                report->set("batch", "graphs_per_s", batch.getGraphCount() / runtime);
+                report->set("phases", "batch", runtime);
+                report->writeData();
+            }
+        }
+        if(report) delete report; report = NULL;
+        release();
+        return 0;
+    }
+
 	auto tick0 = tbb::tick_count::now();
 	string extension = path.substr(path.find_last_of(".")+1);
-	Graph *g = new Graph;
-	g->initFromFile(path);
+	g = new Graph;
+	if(perfCounters) perfCounters->beginPhase();
+	if(!fromSnapshot) g->initFromFile(path);
+	else if(!g->readSnapshot(path)) {
+        cout << "Cannot read the graph snapshot " << path << endl;
+        release();
+        return 1;
+	}
 	auto tick1 = tbb::tick_count::now();
 
 	cout << "Graph read time: " << (tick1-tick0).seconds() << "s" << endl;
+	if(report) report->set("phases", "load", (tick1-tick0).seconds());
+	if(perfCounters) perfCounters->endPhase("load");
 	cout << "Bron Kerbosch for " << path<< endl;
 
-    if(degeneracyOrd) {
+    if(min_clq_size > 1) {
+        // A vertex of a clique of size k has at least k-1 neighbours in the (k-1)-core
         tick0 = tbb::tick_count::now();
+        long removed = g->pruneToCore(min_clq_size - 1);
+        // The ordering of a snapshot only holds for the graph it was taken of
+        if(removed) fromSnapshot = false;
+        SearchBound::raise(min_clq_size);
+        tick1 = tbb::tick_count::now();
+        cout << "Core pruning removed " << removed << " vertices: #Vertex = " << g->getNodeNo() << "; #Edge = " << g->getEdgeNo()
+             << " in " << (tick1 - tick0).seconds() << "s" << endl;
+        if(report) report->set("phases", "core_pruning", (tick1 - tick0).seconds());
+    }
+
+    // Vertex queries do not depend on the ordering
+    bool queryMode = cmdOptionExists(argv, argv+argc, "--query");
+    if(degeneracyOrd && !queryMode && !fromSnapshot) {
+        tick0 = tbb::tick_count::now();
+        if(perfCounters) perfCounters->beginPhase();
         g->degeneracyOrdering();
         tick1 = tbb::tick_count::now();
         std::cout << "Degeneracy = " << g->degeneracy << " Ordering in: " << (tick1 - tick0).seconds() << "s" << endl;
+        if(report) report->set("phases", "ordering", (tick1 - tick0).seconds());
+        if(perfCounters) perfCounters->endPhase("ordering");
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--snapshot-out")) {
+        string snapshot_path = string(getCmdOption(argv, argv + argc, "--snapshot-out"));
+        if(g->writeSnapshot(snapshot_path)) cout << "Graph snapshot written to " << snapshot_path << endl;
+        else cout << "Cannot write the graph snapshot " << snapshot_path << endl;
     }
 
     tick0 = tbb::tick_count::now();
-    g->BronKerboschDegeneracy(nthr);
+    if(perfCounters) perfCounters->beginPhase();
+    g->hashAdjacencyLists();
+    tick1 = tbb::tick_count::now();
+    cout << "Hashing time: " << (tick1 - tick0).seconds() << "s" << endl;
+    if(report) report->set("phases", "hashing", (tick1 - tick0).seconds());
+    if(perfCounters) perfCounters->endPhase("hashing");
+
+    if(cmdOptionExists(argv, argv+argc, "--autotune")) {
+        tick0 = tbb::tick_count::now();
+        int sample_size = 64;
+        if(getCmdOption(argv, argv + argc, "--autotune") && getCmdOption(argv, argv + argc, "--autotune")[0] != '-')
+            sample_size = stoi(string(getCmdOption(argv, argv + argc, "--autotune")));
+        Autotuner tuner(g, nthr, sample_size);
+        string cache_path = path + ".autotune";
+        bool useCache = cmdOptionExists(argv, argv+argc, "--autotune-cache");
+        if(!(useCache && tuner.loadCache(cache_path))) {
+            tuner.collectStatistics();
+            tuner.tune();
+            if(useCache) tuner.saveCache(cache_path);
+        }
+        tuner.apply();
+        tuner.printData();
+        tick1 = tbb::tick_count::now();
+        cout << "Autotuning time: " << (tick1 - tick0).seconds() << "s" << endl;
+        if(report) report->set("phases", "autotune", (tick1 - tick0).seconds());
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--bench")) {
+        int reps = 3;
+        if(cmdOptionExists(argv, argv+argc, "--bench-reps")) reps = max(1, stoi(string(getCmdOption(argv, argv + argc, "--bench-reps"))));
+        BenchDriver bench(g, reps, sampling_int);
+        const char* spec = getCmdOption(argv, argv + argc, "--bench");
+        if(bench.parseGrid(spec && spec[0] != '-' ? string(spec) : string(""), nthr)) {
+            bench.run();
+            bench.printData();
+            string out = "bench.csv";
+            if(cmdOptionExists(argv, argv+argc, "--bench-out")) out = string(getCmdOption(argv, argv + argc, "--bench-out"));
+            if(out.size() > 5 && out.substr(out.size() - 5) == ".json") bench.writeJson(out); else bench.writeCsv(out);
+            cout << "Benchmark results written to " << out << endl;
+        }
+        if(report) delete report; report = NULL;
+        release();
+        return 0;
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--serve")) {
+        MceServer server(g, nthr, string(getCmdOption(argv, argv + argc, "--serve")));
+        server.run();
+        if(report) delete report; report = NULL;
+        release();
+        return 0;
+    }
+
+    if(queryMode) {
+        vertexQueries = new VertexQueries(g, VertexQueries::parse(string(getCmdOption(argv, argv + argc, "--query"))));
+        edgeRoots = false;
+        tick0 = tbb::tick_count::now();
+        vertexQueries->run(nthr);
+        tick1 = tbb::tick_count::now();
+        if(cmdOptionExists(argv, argv+argc, "--query-out")) {
+            string out_path = string(getCmdOption(argv, argv + argc, "--query-out"));
+            ofstream out(out_path);
+            vertexQueries->writeData(out);
+            cout << "Query results written to " << out_path << endl;
+        }
+        else vertexQueries->writeData(cout);
+        cout << "Number of queries: " << vertexQueries->getVertices().size() << "; maximal cliques: " << vertexQueries->getCliqueCount() << endl;
+        cout << "Query time: " << (tick1 - tick0).seconds() << "s" << endl;
+        if(report) {
+            report->set("config", "threads", nthr);
+            report->addHardwareInfo();
+            report->set("graph", "vertices", g->getNodeNo());
+            report->set("graph", "edges", g->getEdgeNo());
+            report->set("phases", "queries", (tick1 - tick0).seconds());
+            report->set("queries", "count", (long) vertexQueries->getVertices().size());
+            report->set("queries", "cliques", vertexQueries->getCliqueCount());
+            report->writeData();
+            delete report; report = NULL;
+        }
+        delete vertexQueries; vertexQueries = NULL;
+        release();
+        return 0;
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--kclique")) {
+        int k = max(1, stoi(string(getCmdOption(argv, argv + argc, "--kclique"))));
+        string list_path = "";
+        if(cmdOptionExists(argv, argv+argc, "--kclique-out")) list_path = string(getCmdOption(argv, argv + argc, "--kclique-out"));
+        tick0 = tbb::tick_count::now();
+        KCliques kcliques(g, k, nthr, list_path);
+        tick1 = tbb::tick_count::now();
+        cout << "Orientation time: " << (tick1 - tick0).seconds() << "s" << endl;
+        if(report) report->set("phases", "orientation", (tick1 - tick0).seconds());
+
+        tick0 = tbb::tick_count::now();
+        if(perfCounters) perfCounters->beginPhase();
+        long count = kcliques.run(nthr);
+        tick1 = tbb::tick_count::now();
+        if(perfCounters) perfCounters->endPhase("kclique", true);
+        if (CollectMemUsage) memLogger->printData();
+        cout << "Number of " << k << "-cliques: " << count << endl;
+        if(!list_path.empty()) cout << "Cliques written to " << list_path << endl;
+        cout << "k-clique counting time: " << (tick1 - tick0).seconds() << "s" << endl;
+        if(report) {
+            report->set("config", "threads", nthr);
+            report->set("config", "thresh", PX_threshold);
+            report->addHardwareInfo();
+            report->set("graph", "vertices", g->getNodeNo());
+            report->set("graph", "edges", g->getEdgeNo());
+            report->set("graph", "degeneracy", g->degeneracy);
+            report->set("phases", "kclique", (tick1 - tick0).seconds());
+            report->set("tasks", "count", BKTask::get_task_count());
+            report->set("kclique", "k", k);
+            report->set("kclique", "count", count);
+            if(CollectMemUsage) report->addMemoryUsage(memLogger);
+            if(perfCounters) report->addPerfCounters(perfCounters);
+            report->writeData();
+            delete report; report = NULL;
+        }
+        release();
+        return 0;
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--max-clique")) {
+        tick0 = tbb::tick_count::now();
+        maxClique = new MaxClique(cmdOptionExists(argv, argv+argc, "--color-bound"));
+        maxClique->heuristic(g, nthr);
+        tick1 = tbb::tick_count::now();
+        cout << "Heuristic clique size: " << maxClique->getSize() << " in " << (tick1 - tick0).seconds() << "s" << endl;
+        if(report) report->set("phases", "heuristic", (tick1 - tick0).seconds());
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--vertex-stats")) vertexStats = new VertexStats(g, string(getCmdOption(argv, argv + argc, "--vertex-stats")));
+    if(cmdOptionExists(argv, argv+argc, "--top-k")) topK = new TopKCliques(max(1, stoi(string(getCmdOption(argv, argv + argc, "--top-k")))));
+
+    ShardPlan* shard = NULL;
+    if(cmdOptionExists(argv, argv+argc, "--shard")) {
+        int shard_index, shard_count;
+        if(!ShardPlan::parse(string(getCmdOption(argv, argv + argc, "--shard")), shard_index, shard_count)) {
+            cout << "--shard expects i/N with 0 <= i < N" << endl;
+            release();
+            return 1;
+        }
+        tick0 = tbb::tick_count::now();
+        shard = new ShardPlan(g, shard_index, shard_count);
+        shard->assign(nthr);
+        tick1 = tbb::tick_count::now();
+        cout << "Shard " << shard_index << "/" << shard_count << ": " << shard->getRoots().size() << " of " << g->getNodeNo()
+             << " roots, assigned in " << (tick1 - tick0).seconds() << "s" << endl;
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--checkpoint")) {
+        if(edgeRoots || maxClique || topK) cout << "--checkpoint only works for the enumeration from vertex roots, it is ignored" << endl;
+        else {
+            double interval = 60;
+            if(cmdOptionExists(argv, argv+argc, "--checkpoint-int")) interval = stod(string(getCmdOption(argv, argv + argc, "--checkpoint-int")));
+            checkpoint = new Checkpoint(g, string(getCmdOption(argv, argv + argc, "--checkpoint")), interval, shard ? &shard->getRoots() : NULL);
+            if(cmdOptionExists(argv, argv+argc, "--resume") && checkpoint->load()) {
+                cout << "Resuming: " << checkpoint->getResumedRoots() << " of " << (shard ? shard->getRoots().size() : g->getNodeNo()) << " roots already finished" << endl;
+                // The checkpoint only keeps the histogram, these would miss the roots of the earlier run
+                if(vertexStats || rootLog || rootStats)
+                    cout << "--vertex-stats, --root-log and --root-stats would only cover the remaining roots, they are ignored with --resume" << endl;
+                if(vertexStats) delete vertexStats; vertexStats = NULL;
+                if(rootLog) delete rootLog; rootLog = NULL;
+                if(rootStats) delete rootStats; rootStats = NULL;
+            }
+            checkpoint->start();
+        }
+    }
+
+    if(cmdOptionExists(argv, argv+argc, "--progress") || cmdOptionExists(argv, argv+argc, "--time-limit")) {
+        double interval = 0, time_limit = 0;
+        if(cmdOptionExists(argv, argv+argc, "--progress")) {
+            interval = 10;
+            const char* arg = getCmdOption(argv, argv + argc, "--progress");
+            if(arg && arg[0] != '-') interval = stod(string(arg));
+        }
+        if(cmdOptionExists(argv, argv+argc, "--time-limit")) time_limit = stod(string(getCmdOption(argv, argv + argc, "--time-limit")));
+        progress = new Progress(interval, time_limit);
+        progress->start();
+    }
+
+    tick0 = tbb::tick_count::now();
+    if(perfCounters) perfCounters->beginPhase();
+    g->BronKerboschDegeneracy(nthr, shard ? &shard->getRoots() : NULL);
     tick1 = tbb::tick_count::now();
     auto bk_time = (tick1 - tick0).seconds();
+    if(progress) {
+        progress->stop();
+        if(TimeBudget::expired) {
+            cout << "Time limit reached: " << progress->getFinishedRoots() << " of " << progress->getTotalRoots() << " roots finished" << endl;
+            if(!maxClique && !topK) {
+                // The histogram of the run also holds the cliques the cut roots found before the deadline
+                map<int, long> finished_hist = progress->getFinishedHistogram();
+                long finished_cliques = 0;
+                for(auto& hist : finished_hist) finished_cliques += hist.second;
+                cout << "The clique histogram holds all the cliques found until the deadline, including the cut roots\n";
+                cout << "# Cliques of the finished roots: " << finished_cliques << "\n";
+                cout << "# clique_size, num_of_cliques\n";
+                for(auto& hist : finished_hist) cout << hist.first << ", " << hist.second << "\n";
+                cout << flush;
+            }
+            if(cmdOptionExists(argv, argv+argc, "--time-limit-out")) {
+                string out_path = string(getCmdOption(argv, argv + argc, "--time-limit-out"));
+                ofstream out(out_path);
+                for(int v : progress->getFinishedVertices()) out << v << "\n";
+                cout << "Finished root vertices written to " << out_path << endl;
+            }
+        }
+    }
+    if(checkpoint) {
+        checkpoint->stop();
+        checkpoint->addResumed(pt_hist);
+        cout << "Checkpoint written to " << string(getCmdOption(argv, argv + argc, "--checkpoint")) << endl;
+    }
+    if(perfCounters) perfCounters->endPhase("enumeration", true);
     if (CollectMemUsage) memLogger->printData();
+    if (rootLog) rootLog->writeData();
+    if (rootStats) rootStats->printData(edgeRoots ? "edge" : "vertex");
+    if (taskTracer) taskTracer->writeData();
+#ifdef COLLECT_ALGO_STATS
+    printAlgoStats();
+#endif
+    if (maxClique) maxClique->printData(cout, !TimeBudget::expired);
+    if (vertexStats) vertexStats->writeData(nthr);
+    if (topK) {
+        if(cmdOptionExists(argv, argv+argc, "--top-k-out")) {
+            string out_path = string(getCmdOption(argv, argv + argc, "--top-k-out"));
+            ofstream out(out_path);
+            topK->writeData(out, !TimeBudget::expired);
+            cout << "Top cliques written to " << out_path << endl;
+        }
+        else topK->writeData(cout, !TimeBudget::expired);
+    }
     cout << "Maximal clique enumeration time: " << bk_time << "s" << endl;
+    if(shard) {
+        string shard_path = "shard_" + string(getCmdOption(argv, argv + argc, "--shard")) + ".txt";
+        replace(shard_path.begin(), shard_path.end(), '/', '_');
+        if(cmdOptionExists(argv, argv+argc, "--shard-out")) shard_path = string(getCmdOption(argv, argv + argc, "--shard-out"));
+        shard->writeResult(shard_path, Graph::cliqueHistogram(pt_hist), bk_time);
+        cout << "Shard result written to " << shard_path << endl;
+        delete shard; shard = NULL;
+    }
+
+    if(report) {
+        string cmd;
+        for(int i = 0; i < argc; i++) cmd += (i ? " " : "") + string(argv[i]);
+        report->set("config", "command", cmd);
+        report->set("config", "input", path);
+        report->set("config", "threads", nthr);
+        report->set("config", "subgraphs", subgraphBased);
+        report->set("config", "thresh", PX_threshold);
+        report->set("config", "mempool", setsMempool);
+        report->set("config", "mem_thresh", mem_threshold);
+        report->set("config", "block_size", memBlockSize);
+        report->set("config", "ordering", degeneracyOrd ? "degeneracy" : (degreeOrd ? "degree" : "inverse degree"));
+        report->set("config", "max_clq", max_clq_size);
+        report->set("config", "min_clq", min_clq_size);
+        report->set("config", "root_cost", root_cost_mode);
+        report->set("config", "eager_roots", eager_roots);
+        report->set("config", "idle_split", idleSplit);
+        report->set("config", "edge_roots", edgeRoots);
+        report->addHardwareInfo();
+        report->set("graph", "vertices", g->getNodeNo());
+        report->set("graph", "edges", g->getEdgeNo());
+        report->set("graph", "max_degree", g->maxdeg);
+        report->set("graph", "degeneracy", g->degeneracy);
+        report->set("phases", "enumeration", bk_time);
+        report->set("tasks", "count", BKTask::get_task_count());
+        if(progress) {
+            report->set("time_limit", "expired", (bool) TimeBudget::expired);
+            report->set("time_limit", "roots_total", (long) progress->getTotalRoots());
+            report->set("time_limit", "roots_finished", (long) progress->getFinishedRoots());
+            if(TimeBudget::expired && !maxClique && !topK) {
+                // cliques.histogram counts every clique found, this one only those of the finished roots
+                string json = "{";
+                for(auto& hist : progress->getFinishedHistogram())
+                    json += (json.size() > 1 ? ", \"" : "\"") + to_string(hist.first) + "\": " + to_string(hist.second);
+                report->setRaw("time_limit", "finished_roots_histogram", json + "}");
+            }
+        }
+        if(maxClique) {
+            report->set("max_clique", "size", maxClique->getSize());
+            report->set("max_clique", "exact", !TimeBudget::expired);
+            string json = "[";
+            for(int v : maxClique->getWitness()) json += (json.size() > 1 ? ", " : "") + to_string(v);
+            report->setRaw("max_clique", "vertices", json + "]");
+        }
+        else if(topK) {
+            string json = "[";
+            for(auto& clique : topK->getCliques()) {
+                json += json.size() > 1 ? ", [" : "[";
+                for(unsigned int i = 0; i < clique.size(); i++) json += (i ? ", " : "") + to_string(clique[i]);
+                json += "]";
+            }
+            report->setRaw("top_k", "cliques", json + "]");
+            report->set("top_k", "complete", !TimeBudget::expired);
+        }
+        else report->addCliqueHistogram(Graph::cliqueHistogram(pt_hist), Graph::cliqueFirstFound(pt_hist));
+        if(CollectMemUsage) report->addMemoryUsage(memLogger);
+        if(perfCounters) report->addPerfCounters(perfCounters);
+#ifdef COLLECT_ALGO_STATS
+        report->addAlgoStats();
+#endif
+        report->writeData();
+        delete report; report = NULL;
+    }
 
 	// Write to the output file
     if(cmdOptionExists(argv, argv+argc, "-p")) g->writeCliqueHist(pt_hist);
-    delete g; g = NULL;
-    if(memLogger) delete memLogger; memLogger = NULL;
+    release();
+    if(maxClique) delete maxClique; maxClique = NULL;
+    if(topK) delete topK; topK = NULL;
+    if(vertexStats) delete vertexStats; vertexStats = NULL;
+    if(checkpoint) delete checkpoint; checkpoint = NULL;
+    if(progress) delete progress; progress = NULL;
 
     return 0;
 }
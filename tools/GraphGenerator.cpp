@@ -0,0 +1,256 @@
+/*
+ * Synthetic graph generator for scaling experiments.
+ *
+ * Writes undirected graphs in the edge list format read by mce: an optional
+ * comment line, a "n n m" header and one "u v" edge per line. Edges are
+ * generated in parallel from counter based random streams, so the output only
+ * depends on the model parameters and the seed, not on the number of threads.
+ * Loops and duplicate edges are removed before writing.
+ *
+ * Models:
+ *   er          Erdos-Renyi G(n, p)
+ *   rmat        R-MAT / Kronecker graph with 2^scale vertices and edgefactor * 2^scale edges
+ *   ba          Barabasi-Albert preferential attachment with d edges per new vertex
+ *   moon-moser  Complete k-partite graph with parts of size 3, it has 3^k maximal cliques
+ *   planted     G(n, p) with a planted clique of size c
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/blocked_range.h>
+#include <tbb/combinable.h>
+#include <tbb/tick_count.h>
+
+#include "utils.h"
+
+using namespace std;
+
+typedef uint64_t Edge; // (u << 32) | v with u < v
+
+inline Edge make_edge(uint32_t u, uint32_t v) { return u < v ? ((Edge) u << 32) | v : ((Edge) v << 32) | u; }
+
+/****************** Random streams ***********************/
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Independent stream for every (seed, index) pair
+struct RandomStream {
+    RandomStream(uint64_t seed, uint64_t index) : state(splitmix64(seed ^ splitmix64(index))) {}
+    uint64_t next() { state += 0x9E3779B97F4A7C15ULL; return splitmix64(state); }
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); } // [0, 1)
+    uint64_t below(uint64_t bound) { return next() % bound; }
+    uint64_t state;
+};
+
+/****************** Models ***********************/
+typedef tbb::combinable<vector<Edge>> EdgeBuffers;
+
+// G(n, p) by geometric skipping over the candidates v > u of every u
+void gen_erdos_renyi(uint64_t n, double p, uint64_t seed, EdgeBuffers& edges) {
+    if(p <= 0) return;
+    double log_q = log(1.0 - min(p, 1.0 - 1e-12));
+    tbb::parallel_for(tbb::blocked_range<uint64_t>(0, n, 64), [&](const tbb::blocked_range<uint64_t>& r) {
+        auto& local = edges.local();
+        for(uint64_t u = r.begin(); u != r.end(); u++) {
+            RandomStream rng(seed, u);
+            uint64_t v = u;
+            while(true) {
+                if(p >= 1) v++;
+                else v += 1 + (uint64_t) floor(log(1.0 - rng.uniform()) / log_q);
+                if(v >= n) break;
+                local.push_back(make_edge(u, v));
+            }
+        }
+    });
+}
+
+void gen_rmat(int scale, uint64_t edge_factor, double a, double b, double c, uint64_t seed, EdgeBuffers& edges) {
+    uint64_t n = 1ULL << scale, m = edge_factor * n;
+    // Vertex labels are permuted, otherwise the high degree vertices all have small ids
+    vector<uint32_t> perm(n);
+    for(uint64_t i = 0; i < n; i++) perm[i] = i;
+    RandomStream prng(seed, ~0ULL);
+    for(uint64_t i = n - 1; i > 0; i--) swap(perm[i], perm[prng.below(i + 1)]);
+
+    tbb::parallel_for(tbb::blocked_range<uint64_t>(0, m, 4096), [&](const tbb::blocked_range<uint64_t>& r) {
+        auto& local = edges.local();
+        for(uint64_t e = r.begin(); e != r.end(); e++) {
+            RandomStream rng(seed, e);
+            uint64_t u = 0, v = 0;
+            for(int level = 0; level < scale; level++) {
+                double x = rng.uniform();
+                int quadrant = x < a ? 0 : (x < a + b ? 1 : (x < a + b + c ? 2 : 3));
+                u = (u << 1) | (quadrant >> 1);
+                v = (v << 1) | (quadrant & 1);
+            }
+            if(u != v) local.push_back(make_edge(perm[u], perm[v]));
+        }
+    });
+}
+
+// Batagelj-Brandes: the endpoint list M has M[2i] = i / d and M[2i+1] = M[r] for a random r <= 2i.
+// Drawing r from a stream per position lets every edge be resolved independently.
+void gen_barabasi_albert(uint64_t n, uint64_t d, uint64_t seed, EdgeBuffers& edges) {
+    uint64_t m = n * d;
+    auto endpoint = [&](uint64_t i) {
+        while(true) {
+            RandomStream rng(seed, i);
+            uint64_t r = rng.below(2 * i + 1);
+            if(r % 2 == 0) return (r / 2) / d;
+            i = r / 2;
+        }
+    };
+    tbb::parallel_for(tbb::blocked_range<uint64_t>(0, m, 4096), [&](const tbb::blocked_range<uint64_t>& r) {
+        auto& local = edges.local();
+        for(uint64_t i = r.begin(); i != r.end(); i++) {
+            uint64_t u = i / d, v = endpoint(i);
+            if(u != v) local.push_back(make_edge(u, v));
+        }
+    });
+}
+
+void gen_moon_moser(uint64_t k, EdgeBuffers& edges) {
+    uint64_t n = 3 * k;
+    tbb::parallel_for(tbb::blocked_range<uint64_t>(0, n, 16), [&](const tbb::blocked_range<uint64_t>& r) {
+        auto& local = edges.local();
+        for(uint64_t u = r.begin(); u != r.end(); u++)
+            for(uint64_t v = (u / 3 + 1) * 3; v < n; v++) local.push_back(make_edge(u, v));
+    });
+}
+
+void gen_planted_clique(uint64_t n, double p, uint64_t c, uint64_t seed, EdgeBuffers& edges) {
+    gen_erdos_renyi(n, p, seed, edges);
+    vector<uint32_t> members;
+    RandomStream rng(seed, ~1ULL);
+    while(members.size() < min(c, n)) {
+        uint32_t v = rng.below(n);
+        if(find(members.begin(), members.end(), v) == members.end()) members.push_back(v);
+    }
+    auto& local = edges.local();
+    for(size_t i = 0; i < members.size(); i++)
+        for(size_t j = i + 1; j < members.size(); j++) local.push_back(make_edge(members[i], members[j]));
+}
+
+/****************** Output ***********************/
+inline char* write_uint(char* out, uint32_t x) {
+    char buf[16]; int len = 0;
+    do { buf[len++] = '0' + x % 10; x /= 10; } while(x);
+    while(len) *out++ = buf[--len];
+    return out;
+}
+
+// Formats blocks of edges in parallel and writes them in order
+void write_edge_list(const string& path, const vector<Edge>& edges, uint64_t n, const string& comment) {
+    ofstream out(path, ios::binary);
+    out << "% " << comment << "\n";
+    out << n << " " << n << " " << edges.size() << "\n";
+    const size_t block = 1 << 16, batch_blocks = 256;
+    vector<string> buffers(batch_blocks);
+    for(size_t start = 0; start < edges.size(); start += block * batch_blocks) {
+        size_t blocks = min(batch_blocks, (edges.size() - start + block - 1) / block);
+        tbb::parallel_for(size_t(0), blocks, [&](size_t k) {
+            size_t begin = start + k * block, end = min(edges.size(), begin + block);
+            string& buf = buffers[k];
+            buf.resize((end - begin) * 22);
+            char* p = &buf[0];
+            for(size_t e = begin; e < end; e++) {
+                p = write_uint(p, edges[e] >> 32); *p++ = ' ';
+                p = write_uint(p, edges[e] & 0xFFFFFFFF); *p++ = '\n';
+            }
+            buf.resize(p - &buf[0]);
+        });
+        for(size_t k = 0; k < blocks; k++) out.write(buffers[k].data(), buffers[k].size());
+    }
+}
+
+inline void printGenHelp() {
+    std::cout << " Synthetic graph generator " << std::endl;
+    std::cout << "    -g                Model: er, rmat, ba, moon-moser, planted" << std::endl;
+    std::cout << "    -o                Path to the output edge list" << std::endl;
+    std::cout << "    --seed            Random seed, default 1" << std::endl;
+    std::cout << "    -n                Number of threads, default 256" << std::endl;
+    std::cout << "    -v                Number of vertices (er, ba, planted), default 1000" << std::endl;
+    std::cout << "    -p                Edge probability (er, planted), default 0.01" << std::endl;
+    std::cout << "    -c                Size of the planted clique (planted), default 10" << std::endl;
+    std::cout << "    -d                Edges per new vertex (ba), default 8" << std::endl;
+    std::cout << "    -k                Number of parts of size 3 (moon-moser), default 10" << std::endl;
+    std::cout << "    --scale           log2 of the number of vertices (rmat), default 16" << std::endl;
+    std::cout << "    --edge-factor     Edges per vertex (rmat), default 16" << std::endl;
+    std::cout << "    --abc             Comma separated R-MAT probabilities a,b,c (rmat), default 0.57,0.19,0.19" << std::endl;
+    std::cout << "    -h, --help        Shows this message" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2 || cmdOptionExists(argv, argv+argc, "-h") || cmdOptionExists(argv, argv+argc, "--help")) {
+        printGenHelp(); return 0;
+    }
+    auto option = [&](const string& name, const string& def) {
+        return cmdOptionExists(argv, argv+argc, name) && getCmdOption(argv, argv + argc, name) ?
+            string(getCmdOption(argv, argv + argc, name)) : def;
+    };
+    string model = option("-g", "er");
+    string path = option("-o", "graph.txt");
+    uint64_t seed = stoull(option("--seed", "1"));
+    int nthr = stoi(option("-n", "256"));
+    uint64_t n = stoull(option("-v", "1000"));
+    double p = stod(option("-p", "0.01"));
+
+    // Vertex ids are written as 32 bit values, so the size is checked before anything is generated
+    int scale = 0;
+    if(model == "rmat") {
+        scale = stoi(option("--scale", "16"));
+        if(scale < 0 || scale > 30) { cout << "--scale must be between 0 and 30, mce supports at most 2^31-1 vertices" << endl; return 1; }
+        n = 1ULL << scale;
+    }
+    else if(model == "moon-moser") {
+        uint64_t k = stoull(option("-k", "10"));
+        if(k > (uint64_t) INT32_MAX / 3) { cout << "mce supports at most 2^31-1 vertices" << endl; return 1; }
+        n = 3 * k;
+    }
+    if(n > (uint64_t) INT32_MAX) { cout << "mce supports at most 2^31-1 vertices" << endl; return 1; }
+
+    tbb::task_scheduler_init init(nthr);
+    EdgeBuffers buffers;
+    auto tick0 = tbb::tick_count::now();
+    if(model == "er") gen_erdos_renyi(n, p, seed, buffers);
+    else if(model == "rmat") {
+        double a = 0.57, b = 0.19, c = 0.19;
+        sscanf(option("--abc", "0.57,0.19,0.19").c_str(), "%lf,%lf,%lf", &a, &b, &c);
+        gen_rmat(scale, stoull(option("--edge-factor", "16")), a, b, c, seed, buffers);
+    }
+    else if(model == "ba") gen_barabasi_albert(n, max(1ULL, stoull(option("-d", "8"))), seed, buffers);
+    else if(model == "moon-moser") gen_moon_moser(n / 3, buffers);
+    else if(model == "planted") gen_planted_clique(n, p, stoull(option("-c", "10")), seed, buffers);
+    else { cout << "Unknown model " << model << endl; return 1; }
+
+    // Gather, then drop duplicate edges
+    size_t total = 0;
+    buffers.combine_each([&](const vector<Edge>& local) { total += local.size(); });
+    vector<Edge> edges;
+    edges.reserve(total);
+    buffers.combine_each([&](const vector<Edge>& local) { edges.insert(edges.end(), local.begin(), local.end()); });
+    buffers.clear();
+    tbb::parallel_sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+    auto tick1 = tbb::tick_count::now();
+    cout << "Generated " << model << " graph: #Vertex = " << n << "; #Edge = " << edges.size()
+         << " in " << (tick1 - tick0).seconds() << "s" << endl;
+
+    string cmd;
+    for(int i = 0; i < argc; i++) cmd += (i ? " " : "") + string(argv[i]);
+    write_edge_list(path, edges, n, "generated by: " + cmd);
+    cout << "Written to " << path << " in " << (tbb::tick_count::now() - tick1).seconds() << "s" << endl;
+    return 0;
+}
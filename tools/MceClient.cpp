@@ -0,0 +1,53 @@
+/*
+ * Client of the mce server (mce --serve <socket>).
+ *
+ * Sends one request, the words after the socket path joined by spaces, and
+ * prints the response, e.g.
+ *   mce_client /tmp/mce.sock enumerate -s 1 --thresh 30
+ *   mce_client /tmp/mce.sock query 5,17,42
+ *   mce_client /tmp/mce.sock topk 10
+ */
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        cout << "Usage: mce_client <socket> <request> [options]" << endl;
+        cout << "Requests: enumerate, query, topk, maxclique, kclique, info, shutdown" << endl;
+        return 1;
+    }
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(strlen(argv[1]) >= sizeof(addr.sun_path)) { cout << "Socket path too long" << endl; return 1; }
+    strcpy(addr.sun_path, argv[1]);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (sockaddr*) &addr, sizeof(addr)) < 0) {
+        cout << "Cannot connect to " << argv[1] << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    string request;
+    for(int i = 2; i < argc; i++) request += (i > 2 ? " " : "") + string(argv[i]);
+    request += "\n";
+    for(size_t sent = 0; sent < request.size(); ) {
+        ssize_t n = send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if(n <= 0) { cout << "Cannot send the request" << endl; close(fd); return 1; }
+        sent += n;
+    }
+
+    char buf[65536];
+    ssize_t n;
+    while((n = recv(fd, buf, sizeof(buf), 0)) > 0) cout.write(buf, n);
+    cout.flush();
+    close(fd);
+    return 0;
+}